@@ -0,0 +1,115 @@
+#! /usr/bin/env python3
+
+# Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+# 
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#  * Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#  * Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#  * Neither the name of NVIDIA CORPORATION nor the names of its
+#    contributors may be used to endorse or promote products derived
+#    from this software without specific prior written permission.
+# 
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+import argparse
+import csv
+import struct
+import sys
+
+# Layout written by MappingLog (src/applications/mapper/mapping-log.hpp).
+log_version = 1
+header_format = '<4sIIIII8Q'
+record_format = '<QQdQdQBB6x'
+status_names = ['success', 'mapping-construction-failure', 'pre-eval-failure', 'eval-failure',
+                'eval-budget-exceeded']
+dimension_names = ['index_factorization', 'permutation', 'spatial', 'bypass']
+no_level = 0xFF
+
+def read_mapping_log(filename):
+    """Yields one dict per record in a per-thread binary mapping log. Mapping IDs
+    are converted from split-local integers into global per-dimension IDs."""
+    with open(filename, 'rb') as f:
+        buf = f.read()
+
+    header_size = struct.calcsize(header_format)
+    (magic, version, record_size, thread_id, num_splits, num_dimensions,
+     *size_halves) = struct.unpack_from(header_format, buf, 0)
+    if magic != b'TLML':
+        raise ValueError('%s is not a Timeloop mapping log' % filename)
+    if version != log_version:
+        raise ValueError('%s: unsupported mapping log version %d' % (filename, version))
+    if record_size != struct.calcsize(record_format):
+        raise ValueError('%s: unexpected record size %d' % (filename, record_size))
+
+    sizes = [size_halves[2*i] | (size_halves[2*i+1] << 64) for i in range(num_dimensions)]
+
+    for offset in range(header_size, len(buf) - record_size + 1, record_size):
+        id_lo, id_hi, energy, cycles, utilization, maccs, status, fail_level = \
+            struct.unpack_from(record_format, buf, offset)
+
+        # Decompose the split-local integer ID (dimension 0 varies fastest).
+        mapping_id = id_lo | (id_hi << 64)
+        values = []
+        for size in sizes:
+            values.append(mapping_id % size)
+            mapping_id //= size
+        # Index factorization IDs are interleaved across splits.
+        values[0] = values[0] * num_splits + thread_id
+
+        record = {'thread': thread_id}
+        record.update(zip(dimension_names, values))
+        record.update({
+            'status': status_names[status],
+            'fail_level': '' if fail_level == no_level else fail_level,
+            'energy': energy,
+            'cycles': cycles,
+            'utilization': utilization,
+            'maccs': maccs
+        })
+        yield record
+
+def main():
+    parser = argparse.ArgumentParser(
+            description='Merge per-thread Timeloop binary mapping logs (*.mappings.<thread>.bin) into CSV.')
+    parser.add_argument('infiles', nargs='+', type=str,
+            help='per-thread binary mapping logs')
+    parser.add_argument('-o', '--outfile', default='-', type=str,
+            help='CSV output file (default: stdout)')
+    parser.add_argument('--valid-only', action='store_true',
+            help='only emit successfully evaluated mappings')
+    options = parser.parse_args()
+
+    outfile = sys.stdout if options.outfile == '-' else open(options.outfile, 'w', newline='')
+    fields = ['thread'] + dimension_names + ['status', 'fail_level', 'energy', 'cycles', 'utilization', 'maccs']
+    writer = csv.DictWriter(outfile, fieldnames=fields)
+    writer.writeheader()
+
+    count = 0
+    for infile in options.infiles:
+        for record in read_mapping_log(infile):
+            if options.valid_only and record['status'] != 'success':
+                continue
+            writer.writerow(record)
+            count += 1
+
+    if outfile is not sys.stdout:
+        outfile.close()
+        print('Wrote %d mappings to %s.' % (count, options.outfile))
+
+if __name__ == '__main__':
+    main()
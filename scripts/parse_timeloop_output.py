@@ -27,10 +27,12 @@
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 import argparse
+import json
 import numpy as np
 import os
 import pickle
 import pprint
+import struct
 import xml.etree.ElementTree as ET
 
 # Output file names.
@@ -230,11 +232,76 @@ def parse_timeloop_stats(filename):
 
     return output
 
+# Schema version of the .stats.json/.stats.bin outputs understood by this script.
+stats_schema_version = 1
+
+def parse_timeloop_json_stats(filename):
+    with open(filename) as f:
+        output = json.load(f)
+    if output['schema_version'] != stats_schema_version:
+        raise ValueError('unsupported stats schema version %d' % output['schema_version'])
+    return output
+
+def parse_timeloop_binary_stats(filename):
+    # Decodes the layout written by model::WriteStatsBinary() into the same
+    # structure as the JSON output.
+    with open(filename, 'rb') as f:
+        buf = f.read()
+    pos = 0
+
+    def get(fmt):
+        nonlocal pos
+        values = struct.unpack_from('<' + fmt, buf, pos)
+        pos += struct.calcsize('<' + fmt)
+        return values if len(values) > 1 else values[0]
+
+    def get_string():
+        nonlocal pos
+        length = get('I')
+        pos += length
+        return buf[pos-length:pos].decode()
+
+    if buf[0:4] != b'TLST':
+        raise ValueError('%s is not a Timeloop binary stats file' % filename)
+    pos = 4
+    output = {'schema_version': get('I')}
+    if output['schema_version'] != stats_schema_version:
+        raise ValueError('unsupported stats schema version %d' % output['schema_version'])
+
+    data_spaces = [get_string() for _ in range(get('I'))]
+    output['data_spaces'] = data_spaces
+    (output['energy'], output['area'], output['cycles'], output['utilization'],
+     output['maccs'], output['last_level_accesses']) = get('ddQdQQ')
+
+    output['levels'] = []
+    for _ in range(get('I')):
+        level = {'name': get_string()}
+        kind = get('B')
+        level['class'] = 'arithmetic' if kind == 0 else 'storage'
+        level['cycles'], level['energy'], level['area'] = get('Qdd')
+        per_ds = [get('QdQQ') for _ in data_spaces]
+        if kind == 0:
+            level['maccs'] = output['maccs']
+            level['utilized_instances'] = per_ds[0][3]
+        else:
+            level['data_spaces'] = {
+                name: dict(zip(['accesses', 'energy', 'tile_size', 'utilized_instances'], values))
+                for name, values in zip(data_spaces, per_ds) }
+        output['levels'].append(level)
+
+    output['networks'] = []
+    for _ in range(get('I')):
+        network = {'name': get_string(), 'energy': get('d')}
+        network['data_spaces'] = { name: {'energy': get('d')} for name in data_spaces }
+        output['networks'].append(network)
+
+    return output
+
 def main():
     parser = argparse.ArgumentParser(
             description='A simple tool for generating pickle files from timeloop output.')
     parser.add_argument('infile', nargs='?', default=xml_file_name, type=str,
-            help='raw Timeloop XML output file')
+            help='raw Timeloop XML, .stats.json or .stats.bin output file')
     parser.add_argument('outfile', nargs='?', default='timeloop-output.pkl', type=argparse.FileType('wb'),
             help='write the output of infile to outfile')
     options = parser.parse_args()
@@ -242,7 +309,12 @@ def main():
     infile = options.infile
     outfile = options.outfile
 
-    output = parse_timeloop_stats(infile)
+    if infile.endswith('.json'):
+        output = parse_timeloop_json_stats(infile)
+    elif infile.endswith('.bin'):
+        output = parse_timeloop_binary_stats(infile)
+    else:
+        output = parse_timeloop_stats(infile)
     with outfile:
         pickle.dump(output, outfile, pickle.HIGHEST_PROTOCOL)
     print('Wrote output to %s.' % (outfile.name))
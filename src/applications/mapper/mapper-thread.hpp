@@ -25,7 +25,11 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <atomic>
+#include <functional>
+
 #include "model/engine.hpp"
+#include "applications/mapper/mapping-log.hpp"
 
 extern bool gTerminate;
 
@@ -58,6 +62,16 @@ static double Cost(const model::Topology::Stats& stats, const std::string metric
   }
 }
 
+// The optional stats (see model::Topology::StatsMask) a metric depends on.
+static unsigned StatsNeeded(const std::string metric)
+{
+  if (metric == "energy" || metric == "edp")
+  {
+    return model::Topology::StatsEnergy;
+  }
+  return 0;
+}
+
 static Betterness IsBetterRecursive_(const model::Topology::Stats& candidate, const model::Topology::Stats& incumbent,
                                      const std::vector<std::string>::const_iterator metric,
                                      const std::vector<std::string>::const_iterator end)
@@ -139,6 +153,11 @@ struct EvaluationResult
   }
 };
 
+// Optional hook invoked on every valid mapping found by a mapper thread.
+// Invocations are serialized across threads. Returning false terminates
+// the search of every mapper thread.
+typedef std::function<bool(const EvaluationResult&)> EvaluationCallback;
+
 //--------------------------------------------//
 //               Mapper Thread                //
 //--------------------------------------------//
@@ -158,18 +177,26 @@ class MapperThread
   bool log_stats_;
   bool log_suboptimal_;
   std::ostream& log_stream_;
+  std::string binary_log_file_name_;
+  std::size_t binary_log_block_size_;
+  unsigned num_threads_;
   bool live_status_;
   bool diagnostics_on_;
+  bool skip_duplicates_;
+  analysis::EvalBudget eval_budget_;
   std::vector<std::string> optimization_metrics_;
   model::Engine::Specs arch_specs_;
   problem::Workload &workload_;
   EvaluationResult* best_;
+  EvaluationCallback callback_;
+  std::atomic<bool>* callback_terminate_;
     
   // Thread-local data.
   std::thread thread_;
   EvaluationResult thread_best_;
   std::vector<uint128_t> invalid_eval_counts_;
   std::vector<Mapping> invalid_eval_sample_mappings_;
+  uint128_t duplicate_count_;
 
  public:
   MapperThread(
@@ -184,12 +211,19 @@ class MapperThread
     bool log_stats,
     bool log_suboptimal,
     std::ostream& log_stream,
+    std::string binary_log_file_name,
+    std::size_t binary_log_block_size,
+    unsigned num_threads,
     bool live_status,
     bool diagnostics_on,
+    bool skip_duplicates,
+    analysis::EvalBudget eval_budget,
     std::vector<std::string> optimization_metrics,
     model::Engine::Specs arch_specs,
     problem::Workload &workload,
-    EvaluationResult* best
+    EvaluationResult* best,
+    EvaluationCallback callback = nullptr,
+    std::atomic<bool>* callback_terminate = nullptr
     ) :
       thread_id_(thread_id),
       search_(search),
@@ -202,15 +236,23 @@ class MapperThread
       log_stats_(log_stats),
       log_suboptimal_(log_suboptimal),
       log_stream_(log_stream),
+      binary_log_file_name_(binary_log_file_name),
+      binary_log_block_size_(binary_log_block_size),
+      num_threads_(num_threads),
       live_status_(live_status),
       diagnostics_on_(diagnostics_on),
+      skip_duplicates_(skip_duplicates),
+      eval_budget_(eval_budget),
       optimization_metrics_(optimization_metrics),
       arch_specs_(arch_specs),
       workload_(workload),
       best_(best),
+      callback_(callback),
+      callback_terminate_(callback_terminate),
       thread_(),
       invalid_eval_counts_(arch_specs_.topology.NumLevels(), 0),
-      invalid_eval_sample_mappings_(arch_specs_.topology.NumLevels())
+      invalid_eval_sample_mappings_(arch_specs_.topology.NumLevels()),
+      duplicate_count_(0)
   {
   }
 
@@ -240,6 +282,11 @@ class MapperThread
     return invalid_eval_sample_mappings_;
   }
 
+  uint128_t DuplicateCount()
+  {
+    return duplicate_count_;
+  }
+
   void Run()
   {
     uint128_t total_mappings = 0;
@@ -253,6 +300,38 @@ class MapperThread
     model::Engine engine;
     engine.Spec(arch_specs_);
 
+    // Optional per-thread binary log of every visited mapping.
+    MappingLog binary_log;
+    if (!binary_log_file_name_.empty())
+    {
+      binary_log.Open(binary_log_file_name_, binary_log_block_size_, thread_id_, num_threads_,
+                      mapspace::ID(mapspace_->AllSizes()));
+    }
+
+    auto first_failed_level = [](const std::vector<model::EvalStatus>& status_per_level)
+      {
+        for (unsigned level = 0; level < status_per_level.size(); level++)
+          if (!status_per_level[level].success)
+            return std::uint8_t(std::min(level, unsigned(kMappingLogNoLevel)));
+        return kMappingLogNoLevel;
+      };
+
+    // Stats computed for every valid mapping: what the optimization metrics
+    // need, plus energy for the per-mapping logs and everything for the
+    // callback. A mapping that becomes the thread's best gets the rest
+    // before it is kept.
+    unsigned stats_mask = 0;
+    for (auto& metric : optimization_metrics_)
+      stats_mask |= StatsNeeded(metric);
+    if (binary_log.IsOpen() || log_suboptimal_)
+      stats_mask |= model::Topology::StatsEnergy;
+    if (callback_)
+      stats_mask = model::Topology::StatsAll;
+
+    // Per-level status of the mapping under evaluation. Kept across
+    // iterations so that copying the engine's status does not allocate.
+    std::vector<model::EvalStatus> status_per_level;
+
     // =================
     // Main mapper loop.
     // =================
@@ -325,6 +404,16 @@ class MapperThread
         terminate = true;
       }
 
+      if (callback_ && *callback_terminate_)
+      {
+        mutex_->lock();
+        log_stream_ << "[" << std::setw(3) << thread_id_ << "] STATEMENT: "
+                    << "evaluation callback requested termination, terminating search."
+                    << std::endl;
+        mutex_->unlock();
+        terminate = true;
+      }
+
       // Try to obtain the next mapping from the search algorithm.
       mapspace::ID mapping_id;
       if (!search_->Next(mapping_id))
@@ -350,6 +439,20 @@ class MapperThread
         break;
       }
 
+      // Skip IDs that construct the same mapping as their canonical
+      // representative, which the search visits (or visited) on its own.
+      if (skip_duplicates_)
+      {
+        auto canonicality = mapspace_->CheckCanonical(mapping_id);
+        if (canonicality != mapspace::MapSpace::Canonicality::Canonical)
+        {
+          duplicate_count_++;
+          search_->Report(canonicality == mapspace::MapSpace::Canonicality::Duplicate ?
+                          search::Status::Duplicate : search::Status::BypassDuplicate);
+          continue;
+        }
+      }
+
       //
       // Periodically sync thread_best with global best.
       //
@@ -381,7 +484,6 @@ class MapperThread
       // complexity and attempt to bail out as quickly as possible at each stage.
       //
       bool success = true;
-      std::vector<model::EvalStatus> status_per_level;
 
       // Stage 1: Construct a mapping from the mapping ID. This step can fail
       //          because the space of *legal* mappings isn't dense (unfortunately),
@@ -394,6 +496,9 @@ class MapperThread
       if (!success)
       {
         invalid_mappings_mapcnstr++;
+        if (binary_log.IsOpen())
+          binary_log.Append(mapping_id.Integer(), MappingLogStatus::MappingConstructionFailure,
+                            kMappingLogNoLevel);
         search_->Report(search::Status::MappingConstructionFailure);
         continue;
       }
@@ -423,15 +528,29 @@ class MapperThread
             }
           }
         }
+        if (binary_log.IsOpen())
+          binary_log.Append(mapping_id.Integer(), MappingLogStatus::PreEvalFailure,
+                            first_failed_level(status_per_level));
         search_->Report(search::Status::EvalFailure);
         continue;
       }
 
       // Stage 3: Heavyweight evaluation.
-      status_per_level = engine.Evaluate(mapping, workload_, !diagnostics_on_);
+      status_per_level = engine.Evaluate(mapping, workload_, !diagnostics_on_, eval_budget_, stats_mask);
       success &= std::accumulate(status_per_level.begin(), status_per_level.end(), true,
                                  [](bool cur, const model::EvalStatus& status)
                                  { return cur && status.success; });
+      if (!success && engine.LastAbortReason() == analysis::AbortReason::BudgetExceeded)
+      {
+        // The nest analysis was cut short, so there is no per-level failure
+        // to diagnose.
+        invalid_mappings_eval++;
+        if (binary_log.IsOpen())
+          binary_log.Append(mapping_id.Integer(), MappingLogStatus::EvalBudgetExceeded,
+                            kMappingLogNoLevel);
+        search_->Report(search::Status::EvalBudgetExceeded);
+        continue;
+      }
       if (!success)
       {
         invalid_mappings_eval++;
@@ -448,12 +567,17 @@ class MapperThread
             }
           }
         }
+        if (binary_log.IsOpen())
+          binary_log.Append(mapping_id.Integer(), MappingLogStatus::EvalFailure,
+                            first_failed_level(status_per_level));
         search_->Report(search::Status::EvalFailure);
         continue;
       }
 
       // SUCCESS!!!
       auto stats = engine.GetTopology().GetStats();
+      if (binary_log.IsOpen())
+        binary_log.Append(mapping_id.Integer(), MappingLogStatus::Success, kMappingLogNoLevel, &stats);
       EvaluationResult result = { true, mapping, stats };
 
       valid_mappings++;
@@ -481,6 +605,12 @@ class MapperThread
       // Is the new mapping "better" than the previous best mapping?
       if (thread_best_.UpdateIfBetter(result, optimization_metrics_))
       {
+        if (stats_mask != model::Topology::StatsAll)
+        {
+          engine.CompleteStats();
+          thread_best_.stats = engine.GetTopology().GetStats();
+        }
+
         if (log_stats_)
         {
           // FIXME: improvement only captures the primary stat.
@@ -497,9 +627,9 @@ class MapperThread
         {
           mutex_->lock();
           log_stream_ << "[" << std::setw(3) << thread_id_ << "]" 
-                      << " Utilization = " << std::setw(4) << std::fixed << std::setprecision(2) << stats.utilization 
-                      << " | pJ/MACC = " << std::setw(8) << std::fixed << std::setprecision(3) << stats.energy /
-            stats.maccs << std::endl;
+                      << " Utilization = " << std::setw(4) << std::fixed << std::setprecision(2) << thread_best_.stats.utilization 
+                      << " | pJ/MACC = " << std::setw(8) << std::fixed << std::setprecision(3) << thread_best_.stats.energy /
+            thread_best_.stats.maccs << std::endl;
           mutex_->unlock();
         }
 
@@ -509,6 +639,15 @@ class MapperThread
       {
         mappings_since_last_best_update++;
       }
+
+      // No more calls once any thread's callback has asked to stop.
+      if (callback_)
+      {
+        mutex_->lock();
+        if (!*callback_terminate_ && !callback_(result))
+          *callback_terminate_ = true;
+        mutex_->unlock();
+      }
     } // while ()
       
     //
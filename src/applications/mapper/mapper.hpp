@@ -44,6 +44,7 @@
 #include "mapspaces/mapspace-factory.hpp"
 #include "search/search-factory.hpp"
 #include "compound-config/compound-config.hpp"
+#include "model/stats-writer.hpp"
 #include "applications/mapper/mapper-thread.hpp"
 
 //--------------------------------------------//
@@ -71,10 +72,15 @@ class Application
   uint128_t sync_interval_;
   bool log_stats_;
   bool log_suboptimal_;
+  bool log_binary_;
+  std::uint32_t log_binary_block_kb_;
   bool live_status_;
   bool diagnostics_on_;
+  bool skip_duplicates_;
   bool emit_whoop_nest_;
+  analysis::EvalBudget eval_budget_;
   std::string out_prefix_;
+  model::StatsFormats stats_formats_;
 
   std::vector<std::string> optimization_metrics_;
 
@@ -83,6 +89,10 @@ class Application
   EvaluationResult best_;
   EvaluationResult global_best_;
 
+  EvaluationCallback callback_ = nullptr;
+  // Raised by a mapper thread whose callback returned false; polled by all.
+  std::atomic<bool> callback_terminate_;
+
  private:
 
   // Serialization
@@ -115,6 +125,7 @@ class Application
     std::string semi_qualified_prefix = name;
     mapper.lookupValue("out_prefix", semi_qualified_prefix);
     out_prefix_ = output_dir + "/" + semi_qualified_prefix;
+    stats_formats_ = model::ParseStatsFormats(mapper, "stats-format");
 
     // Architecture configuration.
     config::CompoundConfigNode arch;
@@ -133,10 +144,7 @@ class Application
 #ifdef USE_ACCELERGY
       // Call accelergy ERT with all input files
       if (arch.exists("subtree") || arch.exists("local")) {
-        accelergy::invokeAccelergy(config->inFiles, semi_qualified_prefix, output_dir);
-        std::string ertPath = out_prefix_ + ".ERT.yaml";
-        auto ertConfig = new config::CompoundConfig(ertPath.c_str());
-        auto ert = ertConfig->getRoot().lookup("ERT");
+        auto ert = accelergy::generateERT(config->inFiles, semi_qualified_prefix, output_dir);
         std::cout << "Generate Accelergy ERT (energy reference table) to replace internal energy model." << std::endl;
         arch_specs_.topology.ParseAccelergyERT(ert);
       }
@@ -200,12 +208,26 @@ class Application
     log_suboptimal_ = false;    
     mapper.lookupValue("log-suboptimal", log_suboptimal_);
     mapper.lookupValue("log-all", log_suboptimal_); // backwards compatibility.
+    log_binary_ = false;
+    mapper.lookupValue("log-binary", log_binary_);
+    log_binary_block_kb_ = 128;
+    mapper.lookupValue("log-binary-block-kb", log_binary_block_kb_);
     live_status_ = false;
     mapper.lookupValue("live-status", live_status_);
     diagnostics_on_ = false;
     mapper.lookupValue("diagnostics", diagnostics_on_);
+    skip_duplicates_ = true;
+    mapper.lookupValue("skip-duplicates", skip_duplicates_);
     emit_whoop_nest_ = false;
     mapper.lookupValue("emit-whoop-nest", emit_whoop_nest_);    
+
+    // Per-mapping evaluation budget (0 = unlimited).
+    double eval_time_limit = 0;
+    mapper.lookupValue("eval-time-limit", eval_time_limit);
+    eval_budget_.max_seconds = eval_time_limit;
+    unsigned long long eval_visit_limit = 0;
+    mapper.lookupValue("eval-visit-limit", eval_visit_limit);
+    eval_budget_.max_level_visits = eval_visit_limit;
     std::cout << "Mapper configuration complete." << std::endl;
 
     // MapSpace configuration.
@@ -234,6 +256,7 @@ class Application
     // }
 
     mapspace_ = mapspace::ParseAndConstruct(mapspace, arch_constraints, arch_specs_, workload_);
+    mapspace_->SetPruneDuplicates(skip_duplicates_);
     split_mapspaces_ = mapspace_->Split(num_threads_);
 
     std::cout << "Mapspace construction complete." << std::endl;
@@ -284,6 +307,13 @@ class Application
     return global_best_;
   }
 
+  // Register a hook to be invoked on every valid mapping found by the
+  // mapper threads (see EvaluationCallback).
+  void SetEvaluationCallback(EvaluationCallback callback)
+  {
+    callback_ = callback;
+  }
+
   // ---------------
   // Run the mapper.
   // ---------------
@@ -296,6 +326,8 @@ class Application
     std::string map_txt_file_name = out_prefix_ + ".map.txt";
     std::string map_cfg_file_name = out_prefix_ + ".map.cfg";
     std::string map_cpp_file_name = out_prefix_ + ".map.cpp";
+    std::string json_file_name = out_prefix_ + ".stats.json";
+    std::string bin_file_name = out_prefix_ + ".stats.bin";
     
     // Prepare live status/log stream.
     std::ofstream log_file;
@@ -335,9 +367,12 @@ class Application
 
     // Prepare the threads.
     std::mutex mutex;
+    callback_terminate_ = false;
     std::vector<MapperThread*> threads_;
     for (unsigned t = 0; t < num_threads_; t++)
     {
+      std::string binary_log_file_name =
+        log_binary_ ? out_prefix_ + ".mappings." + std::to_string(t) + ".bin" : "";
       threads_.push_back(new MapperThread(t, search_.at(t),
                                           split_mapspaces_.at(t),
                                           &mutex,
@@ -348,12 +383,19 @@ class Application
                                           log_stats_,
                                           log_suboptimal_,
                                           live_status_ ? log_file : std::cerr,
+                                          binary_log_file_name,
+                                          std::size_t(log_binary_block_kb_) * 1024,
+                                          num_threads_,
                                           live_status_,
                                           diagnostics_on_,
+                                          skip_duplicates_,
+                                          eval_budget_,
                                           optimization_metrics_,
                                           arch_specs_,
                                           workload_,
-                                          &best_));
+                                          &best_,
+                                          callback_,
+                                          &callback_terminate_));
     }
 
     // Launch the threads.
@@ -442,6 +484,16 @@ class Application
                             engine.GetTopology().GetStats().tile_sizes);
       }
 
+      if (skip_duplicates_)
+      {
+        uint128_t duplicate_count = 0;
+        for (unsigned t = 0; t < num_threads_; t++)
+        {
+          duplicate_count += threads_.at(t)->DuplicateCount();
+        }
+        std::cout << std::endl << "Duplicate mapping IDs skipped: " << duplicate_count << std::endl;
+      }
+
       std::cout << "-----------------------------------------------" << std::endl;
       std::cout << "                 END DIAGNOSTICS               " << std::endl;
       std::cout << "===============================================" << std::endl;
@@ -479,6 +531,20 @@ class Application
       stats_file << engine << std::endl;
       stats_file.close();
 
+      if (stats_formats_.json)
+      {
+        std::ofstream json_file(json_file_name);
+        model::WriteStatsJSON(json_file, engine.GetTopology());
+        json_file.close();
+      }
+
+      if (stats_formats_.binary)
+      {
+        std::ofstream bin_file(bin_file_name, std::ios::binary);
+        model::WriteStatsBinary(bin_file, engine.GetTopology());
+        bin_file.close();
+      }
+
       if (emit_whoop_nest_)
       {
         std::ofstream map_cpp_file(map_cpp_file_name);
@@ -495,12 +561,15 @@ class Application
         global_best_.stats.maccs << std::endl;
 
       // Print the engine stats and mapping to an XML file
-      std::ofstream ofs(xml_file_name);
-      boost::archive::xml_oarchive ar(ofs);
-      ar << boost::serialization::make_nvp("engine", engine);
-      ar << boost::serialization::make_nvp("mapping", global_best_.mapping);
-      const Application* a = this;
-      ar << BOOST_SERIALIZATION_NVP(a);
+      if (stats_formats_.xml)
+      {
+        std::ofstream ofs(xml_file_name);
+        boost::archive::xml_oarchive ar(ofs);
+        ar << boost::serialization::make_nvp("engine", engine);
+        ar << boost::serialization::make_nvp("mapping", global_best_.mapping);
+        const Application* a = this;
+        ar << BOOST_SERIALIZATION_NVP(a);
+      }
     }
     else
     {
@@ -0,0 +1,206 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+#include "util/numeric.hpp"
+#include "model/topology.hpp"
+
+//--------------------------------------------//
+//             Binary Mapping Log             //
+//--------------------------------------------//
+
+// Each mapper thread can stream a fixed-size record for every mapping it
+// visits into its own file. Records are staged in a thread-private block
+// buffer and written out one block at a time, so logging never contends
+// on the mapper's global mutex. scripts/parse_mapping_log.py merges the
+// per-thread files and converts them to CSV.
+//
+// File layout (host byte order):
+//   header: MappingLogHeader
+//   body:   a sequence of MappingLogRecord, in evaluation order.
+
+const std::uint32_t kMappingLogVersion = 1;
+const char kMappingLogMagic[4] = { 'T', 'L', 'M', 'L' };
+
+enum class MappingLogStatus : std::uint8_t
+{
+  Success = 0,
+  MappingConstructionFailure = 1,
+  PreEvalFailure = 2,
+  EvalFailure = 3,
+  EvalBudgetExceeded = 4
+};
+
+// Failing levels use topology numbering (0 is the arithmetic level). This
+// ID is used when a failure cannot be attributed to a level.
+const std::uint8_t kMappingLogNoLevel = 0xFF;
+
+struct MappingLogHeader
+{
+  char magic[4];
+  std::uint32_t version;
+  std::uint32_t record_size;
+  std::uint32_t thread_id;
+  // Mapping IDs are local to a thread's split of the mapspace. The
+  // global index-factorization ID is local * num_splits + thread_id.
+  std::uint32_t num_splits;
+  std::uint32_t num_dimensions;
+  // Per-dimension sizes of this split, as (low, high) 64-bit halves.
+  std::uint64_t dimension_sizes[8];
+};
+
+struct MappingLogRecord
+{
+  // Integer mapping ID within the split, as (low, high) 64-bit halves.
+  std::uint64_t id_lo;
+  std::uint64_t id_hi;
+  double energy;
+  std::uint64_t cycles;
+  double utilization;
+  std::uint64_t maccs;
+  std::uint8_t status;
+  std::uint8_t fail_level;
+  std::uint8_t reserved[6];
+};
+
+static_assert(sizeof(MappingLogHeader) == 88, "unexpected MappingLogHeader padding");
+static_assert(sizeof(MappingLogRecord) == 56, "unexpected MappingLogRecord padding");
+
+static inline void SplitUint128(uint128_t x, std::uint64_t& lo, std::uint64_t& hi)
+{
+  const uint128_t mask = std::numeric_limits<std::uint64_t>::max();
+  lo = static_cast<std::uint64_t>(x & mask);
+  hi = static_cast<std::uint64_t>((x >> 64) & mask);
+}
+
+class MappingLog
+{
+ private:
+  std::ofstream out_;
+  std::vector<char> block_;
+  std::size_t fill_ = 0;
+
+ public:
+  MappingLog() = default;
+  MappingLog(const MappingLog&) = delete;
+  MappingLog& operator = (const MappingLog&) = delete;
+
+  ~MappingLog()
+  {
+    Close();
+  }
+
+  template<int order>
+  void Open(const std::string& file_name, std::size_t block_size,
+            unsigned thread_id, unsigned num_splits,
+            const CartesianCounter<order>& id_space)
+  {
+    static_assert(order <= 4, "mapping log header holds at most 4 dimensions");
+
+    out_.open(file_name, std::ios::binary);
+    if (!out_)
+    {
+      std::cerr << "ERROR: could not open mapping log file " << file_name << std::endl;
+      exit(1);
+    }
+
+    // Round the block down to a whole number of records.
+    std::size_t records_per_block = std::max(block_size / sizeof(MappingLogRecord), std::size_t(1));
+    block_.resize(records_per_block * sizeof(MappingLogRecord));
+    fill_ = 0;
+
+    MappingLogHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMappingLogMagic, sizeof(header.magic));
+    header.version = kMappingLogVersion;
+    header.record_size = sizeof(MappingLogRecord);
+    header.thread_id = thread_id;
+    header.num_splits = num_splits;
+    header.num_dimensions = order;
+    auto sizes = id_space.Base();
+    for (int i = 0; i < order; i++)
+    {
+      SplitUint128(sizes[i], header.dimension_sizes[2*i], header.dimension_sizes[2*i+1]);
+    }
+    out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  }
+
+  bool IsOpen() const
+  {
+    return out_.is_open();
+  }
+
+  void Append(uint128_t mapping_id, MappingLogStatus status, std::uint8_t fail_level,
+              const model::Topology::Stats* stats = nullptr)
+  {
+    MappingLogRecord record;
+    std::memset(&record, 0, sizeof(record));
+    SplitUint128(mapping_id, record.id_lo, record.id_hi);
+    record.status = static_cast<std::uint8_t>(status);
+    record.fail_level = fail_level;
+    if (stats)
+    {
+      record.energy = stats->energy;
+      record.cycles = stats->cycles;
+      record.utilization = stats->utilization;
+      record.maccs = stats->maccs;
+    }
+
+    std::memcpy(block_.data() + fill_, &record, sizeof(record));
+    fill_ += sizeof(record);
+    if (fill_ == block_.size())
+      Flush();
+  }
+
+  void Flush()
+  {
+    if (fill_ > 0)
+    {
+      out_.write(block_.data(), fill_);
+      fill_ = 0;
+    }
+  }
+
+  void Close()
+  {
+    if (out_.is_open())
+    {
+      Flush();
+      out_.close();
+    }
+  }
+};
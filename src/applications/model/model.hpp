@@ -44,6 +44,7 @@
 #include "mapping/arch-properties.hpp"
 #include "mapping/constraints.hpp"
 #include "compound-config/compound-config.hpp"
+#include "model/stats-writer.hpp"
 
 //--------------------------------------------//
 //                Application                 //
@@ -76,6 +77,7 @@ class Application
   bool verbose_ = false;
   bool auto_bypass_on_failure_ = false;
   std::string out_prefix_;
+  model::StatsFormats stats_formats_;
 
  private:
 
@@ -109,6 +111,7 @@ class Application
       model.lookupValue("verbose", verbose_);
       model.lookupValue("auto_bypass_on_failure", auto_bypass_on_failure_);
       model.lookupValue("out_prefix", semi_qualified_prefix);
+      stats_formats_ = model::ParseStatsFormats(model, "stats_format");
     }
 
     out_prefix_ = output_dir + "/" + semi_qualified_prefix;
@@ -151,10 +154,7 @@ class Application
       // Call accelergy ERT with all input files
       if (arch.exists("subtree") || arch.exists("local"))
       {
-        accelergy::invokeAccelergy(config->inFiles, semi_qualified_prefix, output_dir);
-        std::string ertPath = out_prefix_ + ".ERT.yaml";
-        auto ertConfig = new config::CompoundConfig(ertPath.c_str());
-        auto ert = ertConfig->getRoot().lookup("ERT");
+        auto ert = accelergy::generateERT(config->inFiles, semi_qualified_prefix, output_dir);
         if (verbose_)
           std::cout << "Generate Accelergy ERT (energy reference table) to replace internal energy model." << std::endl;
         arch_specs_.topology.ParseAccelergyERT(ert);
@@ -182,7 +182,15 @@ class Application
 
     // Mapping configuration: expressed as a mapspace or mapping.
     auto mapping = rootNode.lookup("mapping");
-    mapping_ = new Mapping(mapping::ParseAndConstruct(mapping, arch_specs_, workload_));
+    try
+    {
+      mapping_ = new Mapping(mapping::ParseAndConstruct(mapping, arch_specs_, workload_));
+    }
+    catch (const mapping::ParseError& e)
+    {
+      std::cerr << "ERROR: " << e.what() << std::endl;
+      exit(1);
+    }
     if (verbose_)
       std::cout << "Mapping construction complete." << std::endl;
 
@@ -217,6 +225,8 @@ class Application
     std::string stats_file_name = out_prefix_ + ".stats.txt";
     std::string xml_file_name = out_prefix_ + ".map+stats.xml";
     std::string map_txt_file_name = out_prefix_ + ".map.txt";
+    std::string json_file_name = out_prefix_ + ".stats.json";
+    std::string bin_file_name = out_prefix_ + ".stats.bin";
 
     model::Engine engine;
     engine.Spec(arch_specs_);
@@ -242,7 +252,7 @@ class Application
         {
           if (verbose_)
             std::cerr << "WARNING: couldn't map level " << level_names.at(level) << ": "
-                      << pre_eval_status[level].fail_reason << ", auto-bypassing."
+                      << pre_eval_status[level].FailReason() << ", auto-bypassing."
                       << std::endl;
           for (unsigned pvi = 0; pvi < problem::GetShape()->NumDataSpaces; pvi++)
             // Ugh... mask is offset-by-1 because level 0 is the arithmetic level.
@@ -256,7 +266,7 @@ class Application
       if (!eval_status[level].success)
       {
         std::cerr << "ERROR: couldn't map level " << level_names.at(level) << ": "
-                  << eval_status[level].fail_reason << std::endl;
+                  << eval_status[level].FailReason() << std::endl;
         exit(1);
       }
     }
@@ -279,15 +289,32 @@ class Application
       std::ofstream stats_file(stats_file_name);
       stats_file << engine << std::endl;
       stats_file.close();
+
+      if (stats_formats_.json)
+      {
+        std::ofstream json_file(json_file_name);
+        model::WriteStatsJSON(json_file, engine.GetTopology());
+        json_file.close();
+      }
+
+      if (stats_formats_.binary)
+      {
+        std::ofstream bin_file(bin_file_name, std::ios::binary);
+        model::WriteStatsBinary(bin_file, engine.GetTopology());
+        bin_file.close();
+      }
     }
 
     // Print the engine stats and mapping to an XML file
-    std::ofstream ofs(xml_file_name);
-    boost::archive::xml_oarchive ar(ofs);
-    ar << BOOST_SERIALIZATION_NVP(engine);
-    ar << BOOST_SERIALIZATION_NVP(mapping);
-    const Application* a = this;
-    ar << BOOST_SERIALIZATION_NVP(a);
+    if (stats_formats_.xml)
+    {
+      std::ofstream ofs(xml_file_name);
+      boost::archive::xml_oarchive ar(ofs);
+      ar << BOOST_SERIALIZATION_NVP(engine);
+      ar << BOOST_SERIALIZATION_NVP(mapping);
+      const Application* a = this;
+      ar << BOOST_SERIALIZATION_NVP(a);
+    }
   }
 };
 
@@ -0,0 +1,487 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <arpa/inet.h>
+#include <csignal>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <set>
+#include <vector>
+
+#include "util/accelergy_interface.hpp"
+#include "util/banner.hpp"
+#include "mapping/parser.hpp"
+#include "compound-config/compound-config.hpp"
+
+extern bool gTerminate;
+
+//--------------------------------------------//
+//                Application                 //
+//--------------------------------------------//
+
+// A long-running model-evaluation server. The architecture (and ERT) and
+// the problem shape are parsed once at startup, and a pool of specced
+// Engines is kept alive to serve evaluation requests arriving over a Unix
+// domain socket.
+//
+// Protocol: every message in either direction is a 4-byte unsigned length
+// (network byte order) followed by that many bytes of payload. A request
+// payload is a configuration document (YAML/JSON by default, see the
+// server.request-format key) carrying a "mapping" directive list and an
+// optional "problem" instance (bounds, coefficients, densities) for the
+// problem shape fixed at startup. A response payload is a flat YAML map
+// with a "status" key (success, failure or error) followed by the
+// top-level stats or the reason for the failure. A client may issue any
+// number of requests on one connection; connections are served
+// concurrently, bounded by the size of the engine pool.
+
+class Application
+{
+ public:
+  std::string name_;
+
+  // Upper bound on the size of a single request.
+  static const std::uint32_t kMaxRequestBytes = 64 * 1024 * 1024;
+
+ protected:
+  // Critical state.
+  problem::Workload workload_;
+  model::Engine::Specs arch_specs_;
+
+  // Engine pool.
+  std::vector<model::Engine*> engines_;
+  std::vector<model::Engine*> idle_engines_;
+  std::mutex pool_mutex_;
+  std::condition_variable pool_cv_;
+
+  // mapping::ParseAndConstruct() works on shared static state and cannot
+  // be called concurrently.
+  std::mutex parse_mutex_;
+
+  // Open client connections.
+  std::set<int> clients_;
+  std::mutex clients_mutex_;
+  std::condition_variable clients_cv_;
+
+  // Application flags/config.
+  bool verbose_ = false;
+  std::uint32_t num_engines_;
+  std::string socket_path_;
+  std::string request_format_;
+  std::string out_prefix_;
+
+ public:
+
+  Application(config::CompoundConfig* config,
+              std::string output_dir = ".",
+              std::string name = "timeloop-server") :
+      name_(name)
+  {
+    auto rootNode = config->getRoot();
+
+    // Server application configuration.
+    std::string semi_qualified_prefix = name;
+    num_engines_ = std::thread::hardware_concurrency();
+    socket_path_ = output_dir + "/" + name + ".sock";
+    request_format_ = "yaml";
+
+    if (rootNode.exists("server"))
+    {
+      auto server = rootNode.lookup("server");
+      server.lookupValue("verbose", verbose_);
+      server.lookupValue("out_prefix", semi_qualified_prefix);
+      server.lookupValue("num-engines", num_engines_);
+      server.lookupValue("socket", socket_path_);
+      server.lookupValue("request-format", request_format_);
+    }
+
+    out_prefix_ = output_dir + "/" + semi_qualified_prefix;
+
+    if (num_engines_ == 0)
+    {
+      num_engines_ = 1;
+    }
+
+    if (verbose_)
+    {
+      for (auto& line: banner)
+        std::cout << line << std::endl;
+      std::cout << std::endl;
+    }
+
+    // Problem configuration. This fixes the problem shape for the lifetime
+    // of the server; requests may only change the problem instance.
+    auto problem = rootNode.lookup("problem");
+    problem::ParseWorkload(problem, workload_);
+    if (verbose_)
+      std::cout << "Problem configuration complete." << std::endl;
+
+    // Architecture configuration.
+    config::CompoundConfigNode arch;
+    if (rootNode.exists("arch"))
+    {
+      arch = rootNode.lookup("arch");
+    }
+    else if (rootNode.exists("architecture"))
+    {
+      arch = rootNode.lookup("architecture");
+    }
+    arch_specs_ = model::Engine::ParseSpecs(arch);
+
+    if (rootNode.exists("ERT"))
+    {
+      auto ert = rootNode.lookup("ERT");
+      if (verbose_)
+        std::cout << "Found Accelergy ERT (energy reference table), replacing internal energy model." << std::endl;
+      arch_specs_.topology.ParseAccelergyERT(ert);
+    }
+    else
+    {
+#ifdef USE_ACCELERGY
+      // Call accelergy ERT with all input files
+      if (arch.exists("subtree") || arch.exists("local"))
+      {
+        auto ert = accelergy::generateERT(config->inFiles, semi_qualified_prefix, output_dir);
+        if (verbose_)
+          std::cout << "Generate Accelergy ERT (energy reference table) to replace internal energy model." << std::endl;
+        arch_specs_.topology.ParseAccelergyERT(ert);
+      }
+#endif
+    }
+
+    if (verbose_)
+      std::cout << "Architecture configuration complete." << std::endl;
+
+    // Engine pool.
+    for (unsigned i = 0; i < num_engines_; i++)
+    {
+      auto engine = new model::Engine();
+      engine->Spec(arch_specs_);
+      engines_.push_back(engine);
+      idle_engines_.push_back(engine);
+    }
+
+    if (verbose_)
+      std::cout << "Engine pool construction complete (" << num_engines_
+                << " engines)." << std::endl;
+  }
+
+  // This class does not support being copied
+  Application(const Application&) = delete;
+  Application& operator=(const Application&) = delete;
+
+  ~Application()
+  {
+    for (auto engine: engines_)
+      delete engine;
+  }
+
+  // Serve requests until gTerminate is raised.
+  void Run()
+  {
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0)
+    {
+      std::cerr << "ERROR: cannot create socket: " << std::strerror(errno) << std::endl;
+      exit(1);
+    }
+
+    struct sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (socket_path_.size() >= sizeof(addr.sun_path))
+    {
+      std::cerr << "ERROR: socket path too long: " << socket_path_ << std::endl;
+      exit(1);
+    }
+    std::strncpy(addr.sun_path, socket_path_.c_str(), sizeof(addr.sun_path) - 1);
+
+    unlink(socket_path_.c_str());
+    if (bind(listen_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(listen_fd, SOMAXCONN) < 0)
+    {
+      std::cerr << "ERROR: cannot listen on socket " << socket_path_ << ": "
+                << std::strerror(errno) << std::endl;
+      exit(1);
+    }
+
+    std::cout << "Listening on " << socket_path_ << std::endl;
+
+    while (!gTerminate)
+    {
+      int client_fd = accept(listen_fd, nullptr, nullptr);
+      if (client_fd < 0)
+      {
+        // EINTR is how SIGINT reaches us while we are blocked here.
+        if (errno == EINTR || errno == ECONNABORTED)
+          continue;
+        std::cerr << "ERROR: accept failed: " << std::strerror(errno) << std::endl;
+        break;
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(clients_mutex_);
+        clients_.insert(client_fd);
+      }
+
+      // Keep SIGINT on this thread so that it interrupts accept().
+      sigset_t sigint_mask, old_mask;
+      sigemptyset(&sigint_mask);
+      sigaddset(&sigint_mask, SIGINT);
+      pthread_sigmask(SIG_BLOCK, &sigint_mask, &old_mask);
+      std::thread(&Application::Serve, this, client_fd).detach();
+      pthread_sigmask(SIG_SETMASK, &old_mask, nullptr);
+    }
+
+    close(listen_fd);
+    unlink(socket_path_.c_str());
+
+    // Kick out any remaining clients and wait for their threads to drain.
+    std::unique_lock<std::mutex> lock(clients_mutex_);
+    for (auto fd: clients_)
+      shutdown(fd, SHUT_RDWR);
+    clients_cv_.wait(lock, [this] { return clients_.empty(); });
+  }
+
+ private:
+
+  // Per-connection request loop.
+  void Serve(int fd)
+  {
+    std::string request;
+    while (!gTerminate && ReadMessage(fd, request))
+    {
+      auto response = Evaluate(request);
+      if (!WriteMessage(fd, response))
+        break;
+    }
+
+    close(fd);
+
+    std::lock_guard<std::mutex> lock(clients_mutex_);
+    clients_.erase(fd);
+    clients_cv_.notify_all();
+  }
+
+  // Exclusive use of one pooled engine for the scope of the lease.
+  struct EngineLease
+  {
+    Application* app;
+    model::Engine* engine;
+
+    EngineLease(Application* app) : app(app)
+    {
+      std::unique_lock<std::mutex> lock(app->pool_mutex_);
+      app->pool_cv_.wait(lock, [app] { return !app->idle_engines_.empty(); });
+      engine = app->idle_engines_.back();
+      app->idle_engines_.pop_back();
+    }
+
+    ~EngineLease()
+    {
+      {
+        std::lock_guard<std::mutex> lock(app->pool_mutex_);
+        app->idle_engines_.push_back(engine);
+      }
+      app->pool_cv_.notify_one();
+    }
+
+    EngineLease(const EngineLease&) = delete;
+    EngineLease& operator=(const EngineLease&) = delete;
+  };
+
+  std::string Evaluate(const std::string& request)
+  {
+    std::ostringstream response;
+
+    // Parse the request. The parsers throw on malformed input.
+    problem::Workload workload = workload_;
+    Mapping mapping;
+    try
+    {
+      config::CompoundConfig config(request, request_format_);
+      auto root = config.getRoot();
+
+      if (root.exists("problem"))
+      {
+        auto problem = root.lookup("problem");
+        if (problem.exists("instance"))
+          problem = problem.lookup("instance");
+        problem::ParseWorkloadInstance(problem, workload);
+      }
+
+      if (!root.exists("mapping"))
+      {
+        response << "status: error" << std::endl
+                 << "message: " << Quote("no mapping in request") << std::endl;
+        return response.str();
+      }
+
+      std::lock_guard<std::mutex> lock(parse_mutex_);
+      mapping = mapping::ParseAndConstruct(root.lookup("mapping"), arch_specs_, workload);
+    }
+    catch (const std::exception& e)
+    {
+      response << "status: error" << std::endl
+               << "message: " << Quote(std::string("malformed request: ") + e.what()) << std::endl;
+      return response.str();
+    }
+
+    // Grab an engine from the pool. It goes back to the pool when the lease
+    // goes out of scope, including when evaluation throws.
+    EngineLease lease(this);
+    auto engine = lease.engine;
+
+    std::vector<model::EvalStatus> eval_status;
+    try
+    {
+      eval_status = engine->Evaluate(mapping, workload);
+    }
+    catch (const std::exception& e)
+    {
+      response << "status: failure" << std::endl
+               << "fail_reason: " << Quote(std::string("evaluation failed: ") + e.what()) << std::endl;
+      return response.str();
+    }
+
+    bool success = true;
+    auto level_names = arch_specs_.topology.LevelNames();
+    for (unsigned level = 0; level < eval_status.size(); level++)
+    {
+      if (!eval_status[level].success)
+      {
+        response << "status: failure" << std::endl
+                 << "fail_level: " << Quote(level_names.at(level)) << std::endl
+                 << "fail_reason: " << Quote(eval_status[level].FailReason()) << std::endl;
+        success = false;
+        break;
+      }
+    }
+
+    if (success && engine->IsEvaluated())
+    {
+      auto& topology = engine->GetTopology();
+      response << std::setprecision(std::numeric_limits<double>::max_digits10)
+               << "status: success" << std::endl
+               << "energy: " << topology.Energy() << std::endl
+               << "area: " << topology.Area() << std::endl
+               << "cycles: " << topology.Cycles() << std::endl
+               << "utilization: " << topology.Utilization() << std::endl
+               << "maccs: " << topology.MACCs() << std::endl
+               << "energy_per_macc: " << topology.Energy() / topology.MACCs() << std::endl
+               << "last_level_accesses: " << topology.LastLevelAccesses() << std::endl;
+    }
+    else if (success)
+    {
+      response << "status: failure" << std::endl
+               << "fail_reason: " << Quote("evaluation abandoned") << std::endl;
+    }
+
+    return response.str();
+  }
+
+  // Double-quoted YAML scalar.
+  static std::string Quote(const std::string& str)
+  {
+    std::string quoted = "\"";
+    for (auto c: str)
+    {
+      if (c == '"' || c == '\\')
+        quoted += '\\';
+      if (c == '\n')
+        quoted += "\\n";
+      else
+        quoted += c;
+    }
+    quoted += "\"";
+    return quoted;
+  }
+
+  // Length-prefixed message I/O.
+  static bool ReadBytes(int fd, char* buf, std::size_t len)
+  {
+    while (len > 0)
+    {
+      ssize_t n = read(fd, buf, len);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        return false;
+      buf += n;
+      len -= n;
+    }
+    return true;
+  }
+
+  static bool WriteBytes(int fd, const char* buf, std::size_t len)
+  {
+    while (len > 0)
+    {
+      ssize_t n = send(fd, buf, len, MSG_NOSIGNAL);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        return false;
+      buf += n;
+      len -= n;
+    }
+    return true;
+  }
+
+  static bool ReadMessage(int fd, std::string& message)
+  {
+    std::uint32_t len;
+    if (!ReadBytes(fd, reinterpret_cast<char*>(&len), sizeof(len)))
+      return false;
+    len = ntohl(len);
+    if (len > kMaxRequestBytes)
+    {
+      std::cerr << "WARNING: dropping client after oversized request ("
+                << len << " bytes)." << std::endl;
+      return false;
+    }
+    message.resize(len);
+    return ReadBytes(fd, &message[0], len);
+  }
+
+  static bool WriteMessage(int fd, const std::string& message)
+  {
+    std::uint32_t len = htonl(static_cast<std::uint32_t>(message.size()));
+    return WriteBytes(fd, reinterpret_cast<const char*>(&len), sizeof(len)) &&
+      WriteBytes(fd, message.data(), message.size());
+  }
+};
@@ -71,10 +71,7 @@ class Application
 #ifdef USE_ACCELERGY
     if (arch.exists("subtree") || arch.exists("local"))
     {
-      accelergy::invokeAccelergy(config->inFiles, out_prefix_, ".");
-      std::string ertPath = out_prefix_ + ".ERT.yaml";
-      auto ertConfig = new config::CompoundConfig(ertPath.c_str());
-      auto ert = ertConfig->getRoot().lookup("ERT");
+      auto ert = accelergy::generateERT(config->inFiles, out_prefix_, ".");
       arch_specs_.topology.ParseAccelergyERT(ert);
     }
 #endif
@@ -160,7 +157,7 @@ class Application
 
             // Configure the model and evaluate the mapping.
             //engine.Spec(arch_specs_);
-            auto status_per_level = engine.Evaluate(mapping, workload_);
+            auto& status_per_level = engine.Evaluate(mapping, workload_);
             success = std::accumulate(status_per_level.begin(), status_per_level.end(), true,
                                       [](bool cur, const model::EvalStatus& status)
                                       { return cur && status.success; });
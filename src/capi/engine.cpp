@@ -0,0 +1,200 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <iostream>
+#include <memory>
+#include <mutex>
+
+#include "capi/timeloop.h"
+#include "capi/stats.hpp"
+#include "mapping/parser.hpp"
+#include "compound-config/compound-config.hpp"
+
+// Globals expected by the model and mapper (normally defined by each
+// application's main.cpp).
+bool gTerminate = false;
+bool gTerminateEval = false;
+
+// mapping::ParseAndConstruct() works on shared static state and cannot be
+// called concurrently.
+static std::mutex gParseMutex;
+
+struct timeloop_engine
+{
+  problem::Workload workload;
+  model::Engine::Specs arch_specs;
+
+  // Engine internals are sized by the problem shape, so the engine can
+  // only be constructed after the shape has been parsed.
+  std::unique_ptr<model::Engine> engine;
+
+  bool stats_valid = false;
+  model::Topology::Stats stats;
+  std::string last_error;
+};
+
+int timeloop_api_version(void)
+{
+  return TIMELOOP_API_VERSION;
+}
+
+timeloop_engine* timeloop_engine_create(const char* config, const char* config_type)
+{
+  if (!config || !config_type)
+    return nullptr;
+
+  auto engine = new timeloop_engine;
+  try
+  {
+    config::CompoundConfig compound_config(config, config_type);
+    auto rootNode = compound_config.getRoot();
+
+    // Problem configuration.
+    auto problem = rootNode.lookup("problem");
+    problem::ParseWorkload(problem, engine->workload);
+
+    // Architecture configuration.
+    config::CompoundConfigNode arch;
+    if (rootNode.exists("arch"))
+    {
+      arch = rootNode.lookup("arch");
+    }
+    else if (rootNode.exists("architecture"))
+    {
+      arch = rootNode.lookup("architecture");
+    }
+    engine->arch_specs = model::Engine::ParseSpecs(arch);
+
+    if (rootNode.exists("ERT"))
+    {
+      auto ert = rootNode.lookup("ERT");
+      engine->arch_specs.topology.ParseAccelergyERT(ert);
+    }
+
+    engine->engine.reset(new model::Engine());
+    engine->engine->Spec(engine->arch_specs);
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "ERROR: timeloop_engine_create: " << e.what() << std::endl;
+    delete engine;
+    return nullptr;
+  }
+
+  return engine;
+}
+
+void timeloop_engine_destroy(timeloop_engine* engine)
+{
+  delete engine;
+}
+
+timeloop_status timeloop_engine_evaluate(timeloop_engine* engine,
+                                         const char* request,
+                                         const char* request_type)
+{
+  if (!engine)
+    return TIMELOOP_ERROR;
+
+  engine->stats_valid = false;
+  engine->last_error.clear();
+
+  if (!request || !request_type)
+  {
+    engine->last_error = "null request";
+    return TIMELOOP_ERROR;
+  }
+
+  problem::Workload workload = engine->workload;
+  Mapping mapping;
+  try
+  {
+    config::CompoundConfig compound_config(request, request_type);
+    auto root = compound_config.getRoot();
+
+    if (root.exists("problem"))
+    {
+      auto problem = root.lookup("problem");
+      if (problem.exists("instance"))
+        problem = problem.lookup("instance");
+      problem::ParseWorkloadInstance(problem, workload);
+    }
+
+    if (!root.exists("mapping"))
+    {
+      engine->last_error = "no mapping in request";
+      return TIMELOOP_ERROR;
+    }
+
+    std::lock_guard<std::mutex> lock(gParseMutex);
+    mapping = mapping::ParseAndConstruct(root.lookup("mapping"), engine->arch_specs, workload);
+  }
+  catch (const std::exception& e)
+  {
+    engine->last_error = std::string("malformed request: ") + e.what();
+    return TIMELOOP_ERROR;
+  }
+
+  auto eval_status = engine->engine->Evaluate(mapping, workload);
+  auto level_names = engine->arch_specs.topology.LevelNames();
+  for (unsigned level = 0; level < eval_status.size(); level++)
+  {
+    if (!eval_status[level].success)
+    {
+      engine->last_error = level_names.at(level) + ": " + eval_status[level].FailReason();
+      return TIMELOOP_EVAL_FAILURE;
+    }
+  }
+
+  if (!engine->engine->IsEvaluated())
+  {
+    engine->last_error = "evaluation abandoned";
+    return TIMELOOP_EVAL_FAILURE;
+  }
+
+  engine->stats = engine->engine->GetTopology().GetStats();
+  engine->stats_valid = true;
+
+  return TIMELOOP_SUCCESS;
+}
+
+timeloop_status timeloop_engine_get_stats(const timeloop_engine* engine,
+                                          timeloop_stats* stats)
+{
+  if (!engine || !stats || !engine->stats_valid)
+    return TIMELOOP_ERROR;
+
+  ExportStats(engine->stats, stats);
+  return TIMELOOP_SUCCESS;
+}
+
+const char* timeloop_engine_last_error(const timeloop_engine* engine)
+{
+  if (!engine)
+    return "null engine";
+  return engine->last_error.c_str();
+}
@@ -0,0 +1,78 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <iostream>
+
+#include "capi/timeloop.h"
+#include "capi/stats.hpp"
+#include "applications/mapper/mapper.hpp"
+#include "compound-config/compound-config.hpp"
+
+timeloop_status timeloop_run_mapper(const char* config,
+                                    const char* config_type,
+                                    const char* output_dir,
+                                    timeloop_mapper_callback callback,
+                                    void* user_data,
+                                    timeloop_stats* best)
+{
+  if (!config || !config_type)
+    return TIMELOOP_ERROR;
+
+  EvaluationResult global_best;
+  try
+  {
+    config::CompoundConfig compound_config(config, config_type);
+
+    Application mapper(&compound_config, output_dir ? output_dir : ".");
+    if (callback)
+    {
+      mapper.SetEvaluationCallback(
+        [callback, user_data](const EvaluationResult& result)
+        {
+          timeloop_stats stats;
+          ExportStats(result.stats, &stats);
+          return callback(&stats, user_data) != 0;
+        });
+    }
+
+    mapper.Run();
+    global_best = mapper.GetGlobalBest();
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "ERROR: timeloop_run_mapper: " << e.what() << std::endl;
+    return TIMELOOP_ERROR;
+  }
+
+  if (!global_best.valid)
+    return TIMELOOP_EVAL_FAILURE;
+
+  if (best)
+    ExportStats(global_best.stats, best);
+
+  return TIMELOOP_SUCCESS;
+}
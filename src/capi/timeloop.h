@@ -0,0 +1,135 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Timeloop C API.
+ *
+ * A thin, stable C interface over the model and mapper for embedding
+ * timeloop in other programs (e.g., via Python ctypes/cffi) without
+ * forking a process and re-parsing output files.
+ *
+ * Configurations are passed as strings in any format accepted by the
+ * command-line tools, identified by a type string ("yaml", "yml" or
+ * "cfg"). JSON documents are valid "yaml". The ERT, if any, must be
+ * included in the configuration; Accelergy is not invoked by the library.
+ *
+ * Limitations inherited from the underlying tools:
+ *  - The problem shape is process-global. Every engine and mapper run in
+ *    a process must use the same problem shape.
+ *  - Malformed configurations that the tools treat as fatal errors still
+ *    terminate the process.
+ *  - An engine handle must not be used by multiple threads at once.
+ *    Different handles may be used concurrently.
+ */
+
+#ifndef TIMELOOP_H
+#define TIMELOOP_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TIMELOOP_API_VERSION 1
+
+typedef enum
+{
+  TIMELOOP_SUCCESS = 0,      /* Mapping evaluated successfully. */
+  TIMELOOP_EVAL_FAILURE = 1, /* Mapping does not fit the architecture. */
+  TIMELOOP_ERROR = 2         /* Bad arguments or malformed input. */
+} timeloop_status;
+
+typedef struct
+{
+  double energy;                 /* pJ */
+  double area;                   /* um^2 */
+  uint64_t cycles;
+  double utilization;
+  uint64_t maccs;
+  uint64_t last_level_accesses;
+} timeloop_stats;
+
+typedef struct timeloop_engine timeloop_engine;
+
+/*
+ * Mapper callback. Invoked on every valid mapping found by the mapper;
+ * invocations are serialized. Return non-zero to continue the search and
+ * zero to stop it (all mapper threads finish their current mapping and
+ * terminate).
+ */
+typedef int (*timeloop_mapper_callback)(const timeloop_stats* stats, void* user_data);
+
+int timeloop_api_version(void);
+
+/*
+ * Create an engine from a configuration containing the architecture
+ * ("arch" or "architecture"), an optional "ERT" and the "problem". The
+ * problem instance given here is the default for evaluations. Returns
+ * NULL on failure.
+ */
+timeloop_engine* timeloop_engine_create(const char* config, const char* config_type);
+
+void timeloop_engine_destroy(timeloop_engine* engine);
+
+/*
+ * Evaluate a mapping. The request is a configuration containing a
+ * "mapping" and, optionally, a "problem" instance (bounds, coefficients,
+ * densities) that overrides the engine's default.
+ */
+timeloop_status timeloop_engine_evaluate(timeloop_engine* engine,
+                                         const char* request,
+                                         const char* request_type);
+
+/* Stats for the last successful evaluation. */
+timeloop_status timeloop_engine_get_stats(const timeloop_engine* engine,
+                                          timeloop_stats* stats);
+
+/*
+ * Description of the last failure on this engine. The string is owned by
+ * the engine and valid until the next call on it.
+ */
+const char* timeloop_engine_last_error(const timeloop_engine* engine);
+
+/*
+ * Run the mapper on a complete mapper configuration (the same input as
+ * timeloop-mapper). Output files are written to output_dir (NULL means
+ * the current directory). The callback may be NULL. On success the stats
+ * of the best mapping are written to best (which may be NULL).
+ */
+timeloop_status timeloop_run_mapper(const char* config,
+                                    const char* config_type,
+                                    const char* output_dir,
+                                    timeloop_mapper_callback callback,
+                                    void* user_data,
+                                    timeloop_stats* best);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TIMELOOP_H */
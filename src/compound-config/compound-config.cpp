@@ -578,6 +578,28 @@ CompoundConfig::CompoundConfig(std::vector<std::string> inputFiles) {
 
 }
 
+CompoundConfig::CompoundConfig(std::string configString, std::string configType) {
+  if (configType == "cfg") {
+    LConfig.readString(configString);
+    auto& lroot = LConfig.getRoot();
+    useLConfig = true;
+    root = CompoundConfigNode(&lroot, YAML::Node(), this);
+  } else if (configType == "yml" || configType == "yaml") {
+    YConfig = YAML::Load(configString);
+    root = CompoundConfigNode(nullptr, YConfig, this);
+    useLConfig = false;
+  } else {
+    std::cerr << "ERROR: unrecognized configuration type: " << configType << std::endl;
+    exit(1);
+  }
+
+  if (root.exists("variables")) {
+    variableRoot = root.lookup("variables");
+  } else {
+    variableRoot = CompoundConfigNode(nullptr, YAML::Node()); // null node
+  }
+}
+
 libconfig::Config& CompoundConfig::getLConfig() {
   return LConfig;
 }
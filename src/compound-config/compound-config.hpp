@@ -129,6 +129,8 @@ class CompoundConfig
   CompoundConfig(const char* inputFile);
   CompoundConfig(char* inputFile) : CompoundConfig((const char*) inputFile) {}
   CompoundConfig(std::vector<std::string> inputFiles);
+  // Parse an in-memory configuration. The type is "cfg", "yml" or "yaml".
+  CompoundConfig(std::string configString, std::string configType);
 
   ~CompoundConfig(){}
 
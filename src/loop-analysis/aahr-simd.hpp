@@ -0,0 +1,127 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// ---------------------------------------------
+//     Vectorized coordinate-array primitives
+// ---------------------------------------------
+// Lane-parallel comparisons over the coordinate arrays of points. Points pad
+// their coordinate storage with zeros to a multiple of kPointLanes, so whole
+// vectors can be loaded for any order. The implementation is selected at
+// build time: AVX2 (8 lanes) when compiled with -mavx2 (scons --avx2), SSE2
+// (4 lanes) on other x86-64 builds, and a scalar loop elsewhere.
+//
+// All masks have bit i set for coordinate i, and bits at or beyond the order
+// are always clear.
+
+namespace simd
+{
+
+#if defined(__AVX2__)
+constexpr unsigned kPointLanes = 8;
+#elif defined(__SSE2__)
+constexpr unsigned kPointLanes = 4;
+#else
+constexpr unsigned kPointLanes = 1;
+#endif
+
+typedef std::uint64_t Mask;
+
+inline unsigned PaddedOrder(unsigned order)
+{
+  return (order + kPointLanes - 1) / kPointLanes * kPointLanes;
+}
+
+inline Mask OrderMask(unsigned order)
+{
+  return order >= 64 ? ~Mask(0) : (Mask(1) << order) - 1;
+}
+
+// Bit i set iff a[i] == b[i].
+inline Mask EqualMask(const std::int32_t* a, const std::int32_t* b, unsigned order)
+{
+  Mask mask = 0;
+  for (unsigned i = 0; i < order; i += kPointLanes)
+  {
+#if defined(__AVX2__)
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    Mask lanes = unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(va, vb))));
+#elif defined(__SSE2__)
+    __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    Mask lanes = unsigned(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(va, vb))));
+#else
+    Mask lanes = (a[i] == b[i]);
+#endif
+    mask |= (lanes << i);
+  }
+  return mask & OrderMask(order);
+}
+
+// Bit i set iff a[i] < b[i].
+inline Mask LessThanMask(const std::int32_t* a, const std::int32_t* b, unsigned order)
+{
+  Mask mask = 0;
+  for (unsigned i = 0; i < order; i += kPointLanes)
+  {
+#if defined(__AVX2__)
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    Mask lanes = unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(vb, va))));
+#elif defined(__SSE2__)
+    __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    Mask lanes = unsigned(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(va, vb))));
+#else
+    Mask lanes = (a[i] < b[i]);
+#endif
+    mask |= (lanes << i);
+  }
+  return mask & OrderMask(order);
+}
+
+// Bit i set iff a[i] != b[i].
+inline Mask NotEqualMask(const std::int32_t* a, const std::int32_t* b, unsigned order)
+{
+  return ~EqualMask(a, b, order) & OrderMask(order);
+}
+
+// Index of the lowest set bit of a non-zero mask.
+inline unsigned FirstLane(Mask mask)
+{
+  return __builtin_ctzll(mask);
+}
+
+} // namespace simd
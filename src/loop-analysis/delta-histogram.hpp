@@ -0,0 +1,122 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace analysis
+{
+
+// ---------------------------------------------------------------
+// Histogram of per-invocation delta sizes at a temporal level.
+// ---------------------------------------------------------------
+// A level sees very few distinct delta sizes (typically one for the first
+// iteration and one for the steady state), so the (size, count) entries are
+// kept sorted in a small inline array and only spill to the heap when a level
+// produces more distinct sizes than that.
+
+class DeltaHistogram
+{
+ public:
+  typedef std::pair<std::uint64_t, std::uint64_t> Entry;
+
+ private:
+  static const std::size_t kInlineCapacity = 4;
+
+  std::array<Entry, kInlineCapacity> inline_entries_;
+  std::vector<Entry> spilled_entries_;
+  std::size_t size_ = 0;
+
+  Entry* Data()
+  {
+    return size_ <= kInlineCapacity ? inline_entries_.data() : spilled_entries_.data();
+  }
+
+  const Entry* Data() const
+  {
+    return size_ <= kInlineCapacity ? inline_entries_.data() : spilled_entries_.data();
+  }
+
+ public:
+  void Add(std::uint64_t delta_size, std::uint64_t count)
+  {
+    Entry* first = Data();
+    Entry* it = std::lower_bound(first, first + size_, delta_size,
+                                 [](const Entry& e, std::uint64_t s) { return e.first < s; });
+    if (it != first + size_ && it->first == delta_size)
+    {
+      it->second += count;
+      return;
+    }
+
+    std::size_t pos = it - first;
+    if (size_ < kInlineCapacity)
+    {
+      std::copy_backward(first + pos, first + size_, first + size_ + 1);
+      inline_entries_[pos] = Entry(delta_size, count);
+    }
+    else
+    {
+      if (size_ == kInlineCapacity)
+      {
+        spilled_entries_.assign(inline_entries_.begin(), inline_entries_.end());
+      }
+      spilled_entries_.insert(spilled_entries_.begin() + pos, Entry(delta_size, count));
+    }
+    size_++;
+  }
+
+  std::uint64_t Get(std::uint64_t delta_size) const
+  {
+    for (auto& e : *this)
+    {
+      if (e.first == delta_size)
+      {
+        return e.second;
+      }
+    }
+    return 0;
+  }
+
+  void clear()
+  {
+    size_ = 0;
+    spilled_entries_.clear();
+  }
+
+  bool empty() const { return size_ == 0; }
+  std::size_t size() const { return size_; }
+
+  const Entry* begin() const { return Data(); }
+  const Entry* end() const { return Data() + size_; }
+};
+
+} // namespace analysis
@@ -27,7 +27,11 @@
 
 #pragma once
 
+#include <unordered_map>
+
 #include "mapping/loop.hpp"
+#include "loop-analysis/delta-histogram.hpp"
+#include "loop-analysis/multicast-histogram.hpp"
 #include "workload/problem-shape.hpp"
 #include "workload/operation-space.hpp"
 
@@ -44,10 +48,13 @@ struct ElementState
 
   // Multicast functionality
   // Stores accesses with various multicast factors for each data type
-  problem::PerDataSpace<std::vector<unsigned long>> accesses;
-  problem::PerDataSpace<std::vector<unsigned long>> scatter_factors;
-  problem::PerDataSpace<std::vector<double>> cumulative_hops;
-  problem::PerDataSpace<std::map<unsigned long, unsigned long>> delta_histograms;
+  problem::PerDataSpace<tiling::MulticastHistogram<unsigned long>> accesses;
+  problem::PerDataSpace<tiling::MulticastHistogram<unsigned long>> scatter_factors;
+  problem::PerDataSpace<tiling::MulticastHistogram<double>> cumulative_hops;
+
+  // Histogram of delta sizes seen at temporal storage boundaries. Only
+  // collected when TIMELOOP_COLLECT_DELTA_HISTOGRAMS is set.
+  problem::PerDataSpace<DeltaHistogram> delta_histograms;
 
   // PE activity
   static constexpr std::uint64_t MAX_TIME_LAPSE = 1;
@@ -67,15 +74,15 @@ struct ElementState
     max_size.fill(0);
     for (auto& it : accesses)
     {
-      it.resize(0);
+      it.clear();
     }
     for (auto& it : scatter_factors)
     {
-      it.resize(0);
+      it.clear();
     }
     for (auto& it : cumulative_hops)
     {
-      it.resize(0);
+      it.clear();
     }
     for (auto& it : delta_histograms)
     {
@@ -104,7 +111,10 @@ class LoopState
  public:
   int level;
   loop::Descriptor descriptor;
-  std::vector<ElementState> live_state; // one for each spatial element
+  // One for each spatial element that has actually been simulated, keyed by
+  // spatial id. Populated lazily: with representative-element simulation
+  // most elements of a uniform level are never materialized.
+  std::unordered_map<std::uint64_t, ElementState> live_state;
 
   LoopState() {}
 
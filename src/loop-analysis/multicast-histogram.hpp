@@ -0,0 +1,156 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
+
+namespace tiling
+{
+
+// ---------------------------------------------------------------
+// Per-multicast-factor counts (accesses, scatter factors, hops).
+// ---------------------------------------------------------------
+// Only a handful of the multicast factors between 1 and the fanout are ever
+// used by a given tile, so the counts are kept as (multicast factor, value)
+// entries sorted by factor. Indexing is by multicast factor (1-based), and
+// factors that were never touched read as zero.
+
+template <typename T>
+class MulticastHistogram
+{
+ public:
+  typedef std::pair<std::uint64_t, T> Entry;
+  typedef typename std::vector<Entry>::iterator iterator;
+  typedef typename std::vector<Entry>::const_iterator const_iterator;
+
+ private:
+  std::vector<Entry> entries_;
+
+  const_iterator Find(std::uint64_t factor) const
+  {
+    return std::lower_bound(entries_.begin(), entries_.end(), factor,
+                            [](const Entry& e, std::uint64_t f) { return e.first < f; });
+  }
+
+ public:
+  T Get(std::uint64_t factor) const
+  {
+    auto it = Find(factor);
+    return (it != entries_.end() && it->first == factor) ? it->second : T(0);
+  }
+
+  // Returns a reference to the value at the given factor, creating a zero
+  // entry if needed.
+  T& operator [] (std::uint64_t factor)
+  {
+    auto it = entries_.begin() + (Find(factor) - entries_.cbegin());
+    if (it == entries_.end() || it->first != factor)
+    {
+      it = entries_.insert(it, Entry(factor, T(0)));
+    }
+    return it->second;
+  }
+
+  void clear() { entries_.clear(); }
+  bool empty() const { return entries_.empty(); }
+  std::size_t size() const { return entries_.size(); }
+
+  iterator begin() { return entries_.begin(); }
+  iterator end() { return entries_.end(); }
+  const_iterator begin() const { return entries_.begin(); }
+  const_iterator end() const { return entries_.end(); }
+
+  std::uint64_t MaxFactor() const
+  {
+    return entries_.empty() ? 0 : entries_.back().first;
+  }
+
+  T Total() const
+  {
+    T total = 0;
+    for (auto& e : entries_)
+    {
+      total += e.second;
+    }
+    return total;
+  }
+
+  // Dense expansion: element i holds the value at multicast factor i+1.
+  std::vector<T> Dense(std::uint64_t num_factors) const
+  {
+    std::vector<T> dense(num_factors, T(0));
+    for (auto& e : entries_)
+    {
+      if (e.first <= num_factors)
+      {
+        dense[e.first - 1] = e.second;
+      }
+    }
+    return dense;
+  }
+
+  // Equality ignores explicit zero entries.
+  bool operator == (const MulticastHistogram& other) const
+  {
+    auto a = entries_.begin(), b = other.entries_.begin();
+    while (true)
+    {
+      while (a != entries_.end() && a->second == T(0)) a++;
+      while (b != other.entries_.end() && b->second == T(0)) b++;
+      if (a == entries_.end() || b == other.entries_.end())
+      {
+        return a == entries_.end() && b == other.entries_.end();
+      }
+      if (a->first != b->first || a->second != b->second)
+      {
+        return false;
+      }
+      a++;
+      b++;
+    }
+  }
+
+  // Serialization.
+  friend class boost::serialization::access;
+
+  template <class Archive>
+  void serialize(Archive& ar, const unsigned int version=0)
+  {
+    if (version == 0)
+    {
+      ar& BOOST_SERIALIZATION_NVP(entries_);
+    }
+  }
+};
+
+} // namespace tiling
@@ -49,6 +49,14 @@ bool gEnableLinkTransfers = (getenv("TIMELOOP_ENABLE_LINK_TRANSFERS") != NULL);
 bool gEnableLinkTransferWarning = false;
 bool gExtrapolateUniformTemporal = true;
 bool gExtrapolateUniformSpatial = (getenv("TIMELOOP_DISABLE_SPATIAL_EXTRAPOLATION") == NULL);
+bool gSimulateRepresentativeElement = (getenv("TIMELOOP_DISABLE_REPRESENTATIVE_ELEMENT") == NULL);
+bool gClosedFormTemporal = (getenv("TIMELOOP_DISABLE_CLOSED_FORM_TEMPORAL") == NULL);
+bool gCollectDeltaHistograms = (getenv("TIMELOOP_COLLECT_DELTA_HISTOGRAMS") != NULL);
+unsigned gSpatialTaskThreads =
+  getenv("TIMELOOP_SPATIAL_THREADS") ? std::max(1, atoi(getenv("TIMELOOP_SPATIAL_THREADS"))) : 1;
+
+// Smallest master spatial level worth splitting across threads.
+const std::uint64_t kMinParallelSpatialElems = 64;
 
 namespace analysis
 {
@@ -63,6 +71,7 @@ void NestAnalysis::Init(problem::Workload* wc, const loop::Nest* nest)
   assert(wc != NULL);
 
   workload_ = wc;
+  abort_reason_ = AbortReason::None;
 
   if (working_sets_computed_ && cached_nest == *nest)
   {
@@ -126,6 +135,14 @@ void NestAnalysis::Reset()
   master_spatial_level_.clear();
   linked_spatial_level_.clear();
 
+  closed_form_level_.clear();
+  closed_form_body_iterations_.clear();
+  closed_form_boundaries_.clear();
+
+  parallel_spatial_level_.clear();
+  parallel_task_unit_.clear();
+  spatial_workers_.clear();
+
   working_sets_computed_ = false;
   
   body_info_.Reset();
@@ -167,7 +184,7 @@ NestAnalysis::GetWorkingSetSizes_LTW() const
   return working_set_sizes;
 }
 
-problem::PerDataSpace<std::vector<tiling::TileInfo>>
+const problem::PerDataSpace<std::vector<tiling::TileInfo>>&
 NestAnalysis::GetWorkingSets()
 {
   if (!working_sets_computed_)
@@ -203,11 +220,60 @@ void NestAnalysis::ComputeWorkingSets()
   if (nest_state_.size() != 0)
   {
     InitializeNestProperties();
-    InitializeLiveState();
 
-    // Recursive call starting from the last element of the list.
-    num_epochs_ = 1;
-    ComputeDeltas(nest_state_.rbegin());
+    // Levels without element offsets never use a representative element.
+    spatial_uniformity_.assign(nest_state_.size(), SpatialUniformity::NonUniform);
+    for (unsigned level = 0; level < nest_state_.size(); level++)
+    {
+      if (!spatial_offsets_[level].empty())
+      {
+        spatial_uniformity_[level] = SpatialUniformity::Unverified;
+      }
+    }
+
+    level_visits_ = 0;
+    if (budget_.max_seconds > 0)
+    {
+      analysis_start_ = std::chrono::steady_clock::now();
+    }
+
+    // Restarts keep the levels found non-uniform so far, and their work
+    // counts against the budget.
+    while (true)
+    {
+      InitializeLiveState();
+
+      // Workers are copied from this analysis before any element state exists.
+      spatial_workers_.clear();
+      if (std::find(parallel_spatial_level_.begin(), parallel_spatial_level_.end(), true) !=
+          parallel_spatial_level_.end())
+      {
+        for (unsigned t = 0; t < gSpatialTaskThreads; t++)
+        {
+          auto worker = std::make_shared<NestAnalysis>(*this);
+          worker->parallel_spatial_level_.assign(nest_state_.size(), false);
+          spatial_workers_.push_back(worker);
+        }
+      }
+
+      PollBudget();
+
+      try
+      {
+        // Recursive call starting from the last element of the list.
+        num_epochs_ = 1;
+        ComputeDeltas(nest_state_.rbegin()->level);
+        break;
+      }
+      catch (EvalAborted&)
+      {
+        if (!restart_)
+        {
+          throw;
+        }
+        restart_ = false;
+      }
+    }
 
     CollectWorkingSets();
   }
@@ -224,6 +290,9 @@ void NestAnalysis::InitializeNestProperties()
   InitStorageBoundaries();
   InitSpatialFanouts();
   InitPerLevelDimScales();
+  InitSpatialOffsets();
+  InitParallelSpatialLevels();
+  InitClosedFormLevels();
 }
 
 void NestAnalysis::InitializeLiveState()
@@ -233,42 +302,85 @@ void NestAnalysis::InitializeLiveState()
   
   body_info_.Reset();
 
-  for (auto loop = nest_state_.rbegin(); loop != nest_state_.rend(); loop++)
+  // Element states are created on first use by GetElementState().
+  for (auto& loop : nest_state_)
+  {
+    loop.live_state.clear();
+  }
+
+  // Traversal scratch space. Frames keep the capacity of their vectors
+  // across invocations.
+  frames_.resize(nest_state_.size());
+  point_sets_.assign(nest_state_.size(), problem::OperationSpace(workload_));
+  deltas_.assign(nest_state_.size(), problem::OperationSpace(workload_));
+}
+
+// Returns the live state of a spatial element at a given level, creating and
+// sizing it on first access.
+analysis::ElementState& NestAnalysis::GetElementState(int level, std::uint64_t spatial_id)
+{
+  // We don't need live state for non-master spatial levels.
+  ASSERT(!loop::IsSpatial(nest_state_[level].descriptor.spacetime_dimension) ||
+         master_spatial_level_[level]);
+  ASSERT(spatial_id < num_spatial_elems_[level]);
+
+  auto& live_state = nest_state_[level].live_state;
+  auto it = live_state.find(spatial_id);
+  if (it != live_state.end())
   {
-    if (!loop::IsSpatial(loop->descriptor.spacetime_dimension) ||
-        master_spatial_level_[loop->level])
+    return it->second;
+  }
+
+  auto& state = live_state[spatial_id];
+  if (linked_spatial_level_[level])
+  {
+    state.prev_point_sets.resize(analysis::ElementState::MAX_TIME_LAPSE);
+    for (auto& elem : state.prev_point_sets)
     {
-      // we don't need live state for non-master spatial levels
-      loop->live_state.resize(num_spatial_elems_[loop->level]);
+      elem.resize(spatial_fanouts_[level]);
     }
+  }
 
-    for (auto& it : loop->live_state)
+  return state;
+}
+
+// Drops the live state of a spatial element fed by a master spatial level
+// (identified by its full spatial id) and of every element below it.
+void NestAnalysis::ReleaseElementState(int master_level, std::uint64_t element_id)
+{
+  // At level l, the element owns ids [element_id * scale, (element_id + 1) * scale),
+  // where scale is the product of the fanouts of the master spatial levels
+  // strictly between l and the master level.
+  std::uint64_t scale = 1;
+  for (int l = master_level - 1; l >= 0; l--)
+  {
+    if (!loop::IsSpatial(nest_state_[l].descriptor.spacetime_dimension) || master_spatial_level_[l])
     {
-      it.Reset();
-      for (auto& acc : it.accesses)  // for each problem variable
-      {
-        acc.resize(spatial_fanouts_[loop->level]);
-      }
-      for (auto& sf : it.scatter_factors)
-      {
-        sf.resize(spatial_fanouts_[loop->level]);
-      }
-      for (auto& ch : it.cumulative_hops)
-      {
-        ch.resize(spatial_fanouts_[loop->level]);
-      }
-      if (linked_spatial_level_[loop->level])
+      auto lo = element_id * scale;
+      auto hi = (element_id + 1) * scale;
+      auto& live_state = nest_state_[l].live_state;
+      for (auto it = live_state.begin(); it != live_state.end(); )
       {
-        it.prev_point_sets.resize(analysis::ElementState::MAX_TIME_LAPSE);
-        for (auto& elem : it.prev_point_sets)
-        {
-          elem.resize(spatial_fanouts_[loop->level]);
-        }
+        it = (it->first >= lo && it->first < hi) ? live_state.erase(it) : std::next(it);
       }
     }
+    if (master_spatial_level_[l])
+    {
+      scale *= spatial_fanouts_[l];
+    }
   }
 }
 
+// The deltas of a master spatial level turned out not to be translations of
+// element 0's, but the state of the elements that would be needed to carry
+// on is gone. Restart the analysis with the full state for this level.
+void NestAnalysis::RestartNonUniform(int level)
+{
+  spatial_uniformity_[level] = SpatialUniformity::NonUniform;
+  restart_ = true;
+  throw EvalAborted();
+}
+
 void NestAnalysis::CollectWorkingSets()
 {
   // Collect the data we want to return. Transpose the max_size_ and accesses_
@@ -279,40 +391,32 @@ void NestAnalysis::CollectWorkingSets()
     bool valid_level = !loop::IsSpatial(cur.descriptor.spacetime_dimension) || master_spatial_level_[cur.level];
     if (valid_level)
     {
+      // Since all elements have the same properties, use the properties
+      // of the first element to build condensed_state.
+      const uint64_t REPR_ELEM_ID = 0;  // representative element id.
+      auto& repr_state = GetElementState(cur.level, REPR_ELEM_ID);
+
       // Contains the collected state for this level.
       analysis::ElementState condensed_state;
       for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
       {
         // Sanity check: All elements in a given level should
         // have similar working sets, accesses etc.
-        // TODO Can we leverage this assertion to avoid redundant simulation
-        // by only simulating one spatial element per level?
         if (!gExtrapolateUniformSpatial)
         {
-          for (std::uint64_t i = 1; i < cur.live_state.size(); i++)
+          for (auto& elem : cur.live_state)
           {
-            ASSERT(cur.live_state[i].accesses[pv] ==
-                   cur.live_state[i - 1].accesses[pv]);
-            ASSERT(cur.live_state[i].max_size[pv] ==
-                   cur.live_state[i - 1].max_size[pv]);
-            ASSERT(cur.live_state[i].link_transfers[pv] ==
-                   cur.live_state[i - 1].link_transfers[pv]);
+            ASSERT(elem.second.accesses[pv] == repr_state.accesses[pv]);
+            ASSERT(elem.second.max_size[pv] == repr_state.max_size[pv]);
+            ASSERT(elem.second.link_transfers[pv] == repr_state.link_transfers[pv]);
           }
         }
 
-        // Since, all elements have the same properties, use the properties
-        // of the first element to build condensed_state
-        const uint64_t REPR_ELEM_ID = 0;  // representative element id.
-        condensed_state.accesses[pv] =
-            cur.live_state[REPR_ELEM_ID].accesses[pv];
-        condensed_state.scatter_factors[pv] =
-            cur.live_state[REPR_ELEM_ID].scatter_factors[pv];
-        condensed_state.cumulative_hops[pv] =
-            cur.live_state[REPR_ELEM_ID].cumulative_hops[pv];
-        condensed_state.max_size[pv] =
-            cur.live_state[REPR_ELEM_ID].max_size[pv];
-        condensed_state.link_transfers[pv] =
-            cur.live_state[REPR_ELEM_ID].link_transfers[pv];
+        condensed_state.accesses[pv] = repr_state.accesses[pv];
+        condensed_state.scatter_factors[pv] = repr_state.scatter_factors[pv];
+        condensed_state.cumulative_hops[pv] = repr_state.cumulative_hops[pv];
+        condensed_state.max_size[pv] = repr_state.max_size[pv];
+        condensed_state.link_transfers[pv] = repr_state.link_transfers[pv];
       }
 
       // Build the subnest corresponding to this level.
@@ -368,28 +472,99 @@ void NestAnalysis::CollectWorkingSets()
   }
 }
 
-// Delta computation (recursive call).
-// Unless skip_delta is true, returns the delta between the working set of the
-// previous iteration and the current iteration of the current level.
-problem::OperationSpace NestAnalysis::ComputeDeltas(
-    std::vector<analysis::LoopState>::reverse_iterator cur, bool skip_delta)
+// Delta computation.
+// Computes the delta between the working set of the previous invocation and
+// the current invocation of the given level, and leaves it in deltas_[level].
+// The sub-nest below the level is walked iteratively: each temporal level
+// tracks its progress through its iteration schedule in frames_[level], and
+// picks up the delta produced by each inner invocation from deltas_[level-1].
+// Spatial levels walk their entire sub-nest within BeginLevel() (see
+// ComputeSpatialWorkingSet), re-entering this routine for the temporal levels
+// below them.
+void NestAnalysis::ComputeDeltas(int top_level)
 {
-  ASSERT(cur != nest_state_.rend());
-  ASSERT(spatial_id_ < cur->live_state.size());
+  int level = top_level;
+  bool entering = true;
 
-  if (gTerminateEval)
+  while (true)
   {
-    throw std::runtime_error("terminated");
+    if (entering)
+    {
+      BeginLevel(level);
+    }
+    else
+    {
+      EndChildIteration(level);
+    }
+
+    if (BeginChildIteration(level))
+    {
+      // Descend into the next-inner level.
+      level--;
+      entering = true;
+      continue;
+    }
+
+    FinishLevel(level);
+
+    if (level == top_level)
+    {
+      break;
+    }
+
+    // Return to the next-outer level.
+    level++;
+    entering = false;
   }
+}
+
+void NestAnalysis::PollBudget()
+{
+  if (gTerminateEval || (budget_.cancel && budget_.cancel->load(std::memory_order_relaxed)))
+  {
+    Abort(AbortReason::Cancelled);
+  }
+
+  if (budget_.max_seconds > 0)
+  {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - analysis_start_;
+    if (elapsed.count() > budget_.max_seconds)
+    {
+      Abort(AbortReason::BudgetExceeded);
+    }
+  }
+}
+
+void NestAnalysis::Abort(AbortReason reason)
+{
+  abort_reason_ = reason;
+  throw EvalAborted();
+}
+
+void NestAnalysis::BeginLevel(int level)
+{
+  level_visits_++;
+  if (budget_.max_level_visits > 0 && level_visits_ > budget_.max_level_visits)
+  {
+    Abort(AbortReason::BudgetExceeded);
+  }
+  if (level_visits_ % kBudgetPollInterval == 0)
+  {
+    PollBudget();
+  }
+
+  auto cur = nest_state_.rbegin() + (nest_state_.size() - 1 - level);
+  ASSERT(cur->level == level);
+
+  auto& frame = frames_[level];
+  frame.state = &GetElementState(level, spatial_id_);
 
-  auto& cur_state = cur->live_state[spatial_id_];
-  
   // The point set for this invocation. Note that we do *not* initialize this to
   // the last-seen state at the end of the prior invocation. Doing so causes the
   // state at this level to grow indefinitely, which isn't what we're trying to
   // model. The responsibility of this level is to supply all the deltas
   // demanded by the next-inner level for this invocation.
-  problem::OperationSpace point_set(workload_);
+  auto& point_set = point_sets_[level];
 
   if (loop::IsSpatial(cur->descriptor.spacetime_dimension))
   {
@@ -397,10 +572,166 @@ problem::OperationSpace NestAnalysis::ComputeDeltas(
   }
   else
   {
-    ComputeTemporalWorkingSet(cur, point_set, cur_state);
+    ComputeTemporalWorkingSet(cur, point_set, *frame.state);
   }
+}
 
-  int level = cur->level;
+// Schedules the next iteration of a temporal level's loop that needs to be
+// simulated, setting up indices_, cur_transform_ and num_epochs_ for it.
+// Returns false once the schedule is exhausted.
+bool NestAnalysis::BeginChildIteration(int level)
+{
+  auto& desc = nest_state_[level].descriptor;
+  if (level == 0 || loop::IsSpatial(desc.spacetime_dimension))
+  {
+    return false;
+  }
+
+  if (closed_form_level_[level])
+  {
+    return false;
+  }
+
+  auto& frame = frames_[level];
+
+  if (!gExtrapolateUniformTemporal)
+  {
+    frame.step_scale = 1;
+    return indices_[level] < desc.end;
+  }
+
+  // What we would like to do is to *NOT* iterate through the entire loop
+  // for this level, but instead fire iterations #0, #1 and #last, and
+  // extrapolate the remainder based on the result of iteration #1.
+
+  // Iteration #last is only required for accurate partition size tracking.
+  // Otherwise, we reset the point set on any gradient change, and so
+  // tracking the point set for the #last iteration is not needed.
+
+  // Note that this entire approach will break if there is any irregularity
+  // in working-set movement along the loop (e.g., a modulus in the index
+  // expression).
+
+  const bool run_last_iteration = false;
+  auto num_iterations = frame.num_iterations;
+
+  switch (frame.phase)
+  {
+    case 0:
+      // Iteration #0.
+      frame.phase = 1;
+      if (num_iterations >= 1)
+      {
+        frame.step_scale = 1;
+        return true;
+      }
+      // fall through
+
+    case 1:
+      // Iterations #1 through #last-1/last.
+      frame.phase = 2;
+      if ((run_last_iteration && num_iterations >= 3) ||
+          (!run_last_iteration && num_iterations >= 2))
+      {
+        // Invoke next (inner) loop level, scaling up the number of epochs
+        // by the number of virtual iterations we want to simulate.
+        frame.step_scale = run_last_iteration ? num_iterations - 2 : num_iterations - 1;
+        frame.saved_epochs = num_epochs_;
+        num_epochs_ *= frame.step_scale;
+        return true;
+      }
+      // fall through
+
+    case 2:
+      // Iteration #last.
+      frame.phase = 3;
+      if (run_last_iteration && num_iterations >= 2)
+      {
+        frame.step_scale = 1;
+        return true;
+      }
+      // fall through
+
+    default:
+      return false;
+  }
+}
+
+// Records the delta returned by the inner level for the iteration of a
+// temporal level's loop that just completed, and advances past it.
+void NestAnalysis::EndChildIteration(int level)
+{
+  auto& desc = nest_state_[level].descriptor;
+  auto& frame = frames_[level];
+
+  int dim = int(desc.dimension);
+  int scale = per_level_dim_scales_[level][dim];
+
+  if (gExtrapolateUniformTemporal && frame.phase == 2)
+  {
+    // Virtual iterations done.
+    num_epochs_ = frame.saved_epochs;
+  }
+
+  if (gExtrapolateUniformTemporal && frame.phase == 3 && frame.num_iterations >= 3)
+  {
+    // If we ran the virtual-iteration logic above, we shouldn't actually
+    // use this returned delta, because we will receive the delta between
+    // iteration #2 and #last. Instead, we just re-use the last delta by
+    // increasing the #virtual iterations (scale) by 1.
+    frame.temporal_delta_scale.back()++;
+  }
+  else
+  {
+    frame.temporal_delta_sizes.push_back(deltas_[level - 1].GetSizes());
+    frame.temporal_delta_scale.push_back(frame.step_scale);
+    cur_transform_[dim] += (scale * frame.step_scale);
+  }
+
+  indices_[level] += (desc.stride * frame.step_scale);
+}
+
+void NestAnalysis::FinishLevel(int level)
+{
+  auto& desc = nest_state_[level].descriptor;
+  auto& frame = frames_[level];
+  auto& cur_state = *frame.state;
+  auto& point_set = point_sets_[level];
+
+  if (level > 0 && !loop::IsSpatial(desc.spacetime_dimension))
+  {
+    cur_transform_[int(desc.dimension)] = frame.saved_transform;
+
+    if (storage_boundary_level_[level - 1])
+    {
+      // Track accesses for only those levels that are relevant
+      // in the final analysis after CollapseTiles.
+      problem::PerDataSpace<std::size_t> final_delta_sizes;
+      final_delta_sizes.fill(0);
+
+      auto num_deltas = frame.temporal_delta_sizes.size();
+      for (unsigned i = 0; i < num_deltas; i++)
+      {
+        for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
+        {
+          final_delta_sizes[pv] += (frame.temporal_delta_sizes[i][pv] * frame.temporal_delta_scale[i]);
+        }
+      }
+
+      problem::PerDataSpace<std::uint64_t> fills;
+      for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
+      {
+        fills[pv] = final_delta_sizes[pv] * num_epochs_;
+
+        // Update delta histogram. Hypothesis is we only need to do this for temporal levels.
+        if (gCollectDeltaHistograms)
+        {
+          cur_state.delta_histograms[pv].Add(final_delta_sizes[pv], num_epochs_);
+        }
+      }
+      AccumulateFills(cur_state, fills);
+    } // storage boundary
+  }
 
   // Record the maximum point set size ever seen across all invocations
   // of this level.
@@ -417,7 +748,7 @@ problem::OperationSpace NestAnalysis::ComputeDeltas(
   }
 
   // Reset indices
-  indices_[level] = cur->descriptor.start;
+  indices_[level] = desc.start;
 
   bool dump = false; // (level >= 4);
   if (dump)
@@ -433,24 +764,17 @@ problem::OperationSpace NestAnalysis::ComputeDeltas(
   }
   
   // Calculate delta to send up to caller.
-  problem::OperationSpace delta(workload_);
-  if (!skip_delta)
-  {
-    delta = point_set - cur_state.last_point_set;
-  }
+  deltas_[level] = point_set - cur_state.last_point_set;
 
   if (dump)
   {
     std::cout << "    Delta:\n";
-    delta.Print();
-    //std::cout << "    New after Minus op:\n";
-    //point_set.Print();
+    deltas_[level].Print();
   }    
 
-  // Update last-seen point set for this level.
-  cur_state.last_point_set = point_set;
-
-  return delta;
+  // Update last-seen point set for this level. The scratch point set is
+  // rebuilt on the next invocation, so there is no need to copy it.
+  std::swap(cur_state.last_point_set, point_set);
 }
 
 void NestAnalysis::ComputeTemporalWorkingSet(std::vector<analysis::LoopState>::reverse_iterator cur,
@@ -515,6 +839,9 @@ void NestAnalysis::ComputeTemporalWorkingSet(std::vector<analysis::LoopState>::r
 
   //
   // Step II: Compute Accesses by accumulating deltas returned by inner levels.
+  // For level 0 this is done directly. For all other levels, the deltas are
+  // accumulated as ComputeDeltas() runs the inner levels, and the accesses
+  // are tallied in FinishLevel().
   //
   std::uint64_t num_iterations = 1 +
     ((cur->descriptor.end - 1 - cur->descriptor.start) /
@@ -522,206 +849,152 @@ void NestAnalysis::ComputeTemporalWorkingSet(std::vector<analysis::LoopState>::r
 
   if (level == 0) // base
   {
-    auto body_iterations = num_iterations * num_epochs_;
-    // macs_ += body_iterations;
-    if (spatial_id_ == 0)
+    AccumulateBodyAccesses(cur_state, num_iterations * num_epochs_);
+  }
+  else if (closed_form_level_[level])
+  {
+    // Every invocation of level 0 below this level (real or extrapolated)
+    // adds its trip count times the running epoch count, so the total is
+    // simply the product of the trip counts of this level and all levels
+    // below it.
+    AccumulateBodyAccesses(GetElementState(0, spatial_id_),
+                           num_iterations * closed_form_body_iterations_[level] * num_epochs_);
+
+    for (auto& boundary : closed_form_boundaries_[level])
     {
-      // To avoid double counting of compute_cycles when there are multiple PEs.
-      // compute_cycles_ += body_iterations;
-      body_info_.accesses += body_iterations;
+      ComputeClosedFormBoundary(boundary);
     }
 
-    for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
-    {
-      // Write-backs of read-modify-write data types consume 2
-      // accesses *except* for the first write.
-      if (problem::GetShape()->IsReadWriteDataSpace.at(pv) &&
-          cur_state.accesses[pv][0] != 0)
-      {
-        cur_state.accesses[pv][0] += body_iterations; // (2 * body_iterations); This fixup now happens in model/buffer.cpp.
-      }
-      else
-      {
-        cur_state.accesses[pv][0] += body_iterations;
-      }
-
-      // Set scatter factor (otherwise it will stay at 0 for temporal levels).
-      cur_state.scatter_factors[pv][0] = 1;
-
-      // Set cumulative hops for temporal levels.
-      cur_state.cumulative_hops[pv][0] = 0.0;
-    }
+    auto& frame = frames_[level];
+    frame.saved_transform = cur_transform_[int(cur->descriptor.dimension)];
+    frame.temporal_delta_sizes.clear();
+    frame.temporal_delta_scale.clear();
+    indices_[level] = cur->descriptor.start;
   }
-  else // recurse
+  else
   {
-    std::vector<problem::PerDataSpace<std::size_t>> temporal_delta_sizes;
-    std::vector<std::uint64_t> temporal_delta_scale;
-
-    bool run_last_iteration = false;
-      
-    if (gExtrapolateUniformTemporal)
-    {
-      // What we would like to do is to *NOT* iterate through the entire loop
-      // for this level, but instead fire iterations #0, #1 and #last, and
-      // extrapolate the remainder based on the result of iteration #1.
-
-      // Iteration #last is only required for accurate partition size tracking.
-      // Otherwise, we reset the point set on any gradient change, and so
-      // tracking the point set for the #last iteration is not needed.
-
-      // Note that this entire approach will break if there is any irregularity
-      // in working-set movement along the loop (e.g., a modulus in the index
-      // expression).
-
-      int dim = int(cur->descriptor.dimension);
-      int scale = per_level_dim_scales_[level][dim];
-      auto saved_transform = cur_transform_[dim];
-
-      // Iteration #0.
-      indices_[level] = cur->descriptor.start;
-      if (num_iterations >= 1)
-      {
-        // Invoke next (inner) loop level.
-        ++cur;
-        auto temporal_delta = ComputeDeltas(cur, false);
-        --cur;
-
-        temporal_delta_sizes.push_back(temporal_delta.GetSizes());
-        temporal_delta_scale.push_back(1);
-        cur_transform_[dim] += scale;
-
-        indices_[level] += cur->descriptor.stride;
-      }
-
-      // Iterations #1 through #last-1/last.
-      if ((run_last_iteration && num_iterations >= 3) ||
-          (!run_last_iteration && num_iterations >= 2))
-      {
-        // Invoke next (inner) loop level, scaling up the number of epochs
-        // by the number of virtual iterations we want to simulate.
-        std::uint64_t virtual_iterations =
-          run_last_iteration ? num_iterations - 2 : num_iterations - 1;
-
-        auto saved_epochs = num_epochs_;
-        num_epochs_ *= virtual_iterations;
-
-        ++cur;
-        auto temporal_delta = ComputeDeltas(cur, false);
-        --cur;
-
-        num_epochs_ = saved_epochs;
-
-        temporal_delta_sizes.push_back(temporal_delta.GetSizes());
-        temporal_delta_scale.push_back(virtual_iterations);
-
-        cur_transform_[dim] += (scale * virtual_iterations);
-
-        indices_[level] += (cur->descriptor.stride * virtual_iterations);
-      }
-
-      // Iteration #last.
-      if (run_last_iteration && num_iterations >= 2)
-      {
-        // Invoke next (inner) loop level.
-        ++cur;
-        auto temporal_delta = ComputeDeltas(cur, false);
-        --cur;
+    // Set up the iteration schedule for this level. The iterations
+    // themselves are driven by ComputeDeltas().
+    auto& frame = frames_[level];
+    frame.num_iterations = num_iterations;
+    frame.phase = 0;
+    frame.saved_transform = cur_transform_[int(cur->descriptor.dimension)];
+    frame.temporal_delta_sizes.clear();
+    frame.temporal_delta_scale.clear();
+
+    indices_[level] = cur->descriptor.start;
+  }
+}
 
-        // If we ran the virtual-iteration logic above, we shouldn't actually
-        // use this returned delta, because we will receive the delta between
-        // iteration #2 and #last. Instead, we just re-use the last delta by
-        // increasing the #virtual iterations (scale) by 1.
-        if (num_iterations >= 3)
-        {
-          temporal_delta_scale.back()++;
-        }
-        else
-        {
-          temporal_delta_sizes.push_back(temporal_delta.GetSizes());
-          temporal_delta_scale.push_back(1);
-          cur_transform_[dim] += scale;
-        }
-      
-        indices_[level] += cur->descriptor.stride;        
-      }
+// Tallies accesses to the innermost (compute-facing) level by the given
+// number of body iterations, for the current spatial element.
+void NestAnalysis::AccumulateBodyAccesses(analysis::ElementState& cur_state,
+                                          std::uint64_t body_iterations)
+{
+  // macs_ += body_iterations;
+  if (spatial_id_ == 0)
+  {
+    // To avoid double counting of compute_cycles when there are multiple PEs.
+    // compute_cycles_ += body_iterations;
+    body_info_.accesses += body_iterations;
+  }
 
-      cur_transform_[dim] = saved_transform;
+  for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
+  {
+    // Write-backs of read-modify-write data types consume 2
+    // accesses *except* for the first write.
+    if (problem::GetShape()->IsReadWriteDataSpace.at(pv) &&
+        cur_state.accesses[pv].Get(1) != 0)
+    {
+      cur_state.accesses[pv][1] += body_iterations; // (2 * body_iterations); This fixup now happens in model/buffer.cpp.
     }
-    else // not gExtrapolateUniformTemporal
+    else
     {
-      int dim = int(cur->descriptor.dimension);
-      int scale = per_level_dim_scales_[level][dim];
-
-      auto saved_transform = cur_transform_[dim];
-
-      for (indices_[level] = cur->descriptor.start;
-           indices_[level] < cur->descriptor.end;
-           indices_[level] += cur->descriptor.stride)
-      {
-        // Invoke next (inner) loop level.
-        ++cur;
-        auto temporal_delta = ComputeDeltas(cur);
-        --cur;
+      cur_state.accesses[pv][1] += body_iterations;
+    }
 
-        temporal_delta_sizes.push_back(temporal_delta.GetSizes());
-        temporal_delta_scale.push_back(1);
+    // Set scatter factor (otherwise it will stay at 0 for temporal levels).
+    cur_state.scatter_factors[pv][1] = 1;
 
-        cur_transform_[dim] += scale;
-      }
+    // Set cumulative hops for temporal levels.
+    cur_state.cumulative_hops[pv][1] = 0.0;
+  }
+}
 
-      cur_transform_[dim] = saved_transform;
-    } // gExtrapolateUniformTemporal
-    
-    if (dump)
+// Tallies fills into a temporal level from the storage boundary below it,
+// for the current spatial element.
+void NestAnalysis::AccumulateFills(analysis::ElementState& cur_state,
+                                   const problem::PerDataSpace<std::uint64_t>& fills)
+{
+  for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
+  {
+    // Write-backs of read-modify-write data types consume 2
+    // accesses *except* for the first write.
+    if (problem::GetShape()->IsReadWriteDataSpace.at(pv) &&
+        cur_state.accesses[pv].Get(1) != 0)
     {
-      std::cout << "-------\n";
-      std::cout << "LEVEL " << level << std::endl;
-      std::cout << "-------\n";
+      cur_state.accesses[pv][1] += fills[pv]; // (2 * fills[pv]); This fixup now happens in model/buffer.cpp.
     }
-
-    if (storage_boundary_level_[level - 1])
+    else
     {
-      // Track accesses for only those levels that are relevant
-      // in the final analysis after CollapseTiles.
-      problem::PerDataSpace<std::size_t> final_delta_sizes;
-      final_delta_sizes.fill(0);
+      cur_state.accesses[pv][1] += fills[pv];
+    }
 
-      auto num_deltas = temporal_delta_sizes.size();
-      for (unsigned i = 0; i < num_deltas; i++)
-      {
-        for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
-        {
-          final_delta_sizes[pv] += (temporal_delta_sizes[i][pv] * temporal_delta_scale[i]);
-        }
-      }
+    // Set scatter factor (otherwise it will stay at 0 for temporal levels).
+    cur_state.scatter_factors[pv][1] = 1;
 
-      for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
-      {
-        // Write-backs of read-modify-write data types consume 2
-        // accesses *except* for the first write.
-        if (problem::GetShape()->IsReadWriteDataSpace.at(pv) &&
-            cur_state.accesses[pv][0] != 0)
-        {
-          cur_state.accesses[pv][0] += final_delta_sizes[pv] * num_epochs_; // (2 * final_delta_sizes[pv] * num_epochs_); This fixup now happens in model/buffer.cpp.
-        }
-        else
-        {
-          cur_state.accesses[pv][0] += final_delta_sizes[pv] * num_epochs_;
-        }
+    // Set cumulative hops for temporal levels.
+    cur_state.cumulative_hops[pv][1] = 0.0;
+  }
+}
+
+// Stands in for every invocation of a storage boundary below a closed-form
+// level during one invocation of that level. Only the first delta depends
+// on the boundary's live state; the rest are fixed by the schedule (see
+// InitClosedFormLevels()).
+void NestAnalysis::ComputeClosedFormBoundary(const ClosedFormBoundary& boundary)
+{
+  int level = boundary.level;
+  auto& cur_state = GetElementState(level, spatial_id_);
+
+  problem::OperationPoint low_problem_point;
+  problem::OperationPoint high_problem_point;
+  for (unsigned dim = 0; dim < unsigned(problem::GetShape()->NumDimensions); dim++)
+  {
+    low_problem_point[dim] = cur_transform_[dim] + mold_low_[level][dim];
+    high_problem_point[dim] = cur_transform_[dim] + mold_high_[level][dim];
+  }
+  auto& point_set = point_sets_[level];
+  point_set = problem::OperationSpace(workload_, low_problem_point, high_problem_point);
 
-        // Set scatter factor (otherwise it will stay at 0 for temporal levels).
-        cur_state.scatter_factors[pv][0] = 1;
+  auto sizes = point_set.GetSizes();
+  std::transform(sizes.begin(), sizes.end(), cur_state.max_size.begin(),
+                 cur_state.max_size.begin(),
+                 [](std::size_t x, std::size_t y) { return std::max(x, y); });
 
-        // Set cumulative hops for temporal levels.
-        cur_state.cumulative_hops[pv][0] = 0.0;
+  auto first_delta_sizes = (point_set - cur_state.last_point_set).GetSizes();
 
-        // Update delta histogram. Hypothesis is we only need to do this for temporal levels.
-        cur_state.delta_histograms[pv][final_delta_sizes[pv]] += num_epochs_;
-        
-      } // for (datatype)
-    } // storage boundary
-    
-  } // level > 0
+  problem::PerDataSpace<std::uint64_t> fills;
+  for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
+  {
+    fills[pv] = (first_delta_sizes[pv] + boundary.fills[pv]) * num_epochs_;
+  }
+  AccumulateFills(GetElementState(level + 1, spatial_id_), fills);
+
+  if (boundary.moved)
+  {
+    // Every step after the first left a fresh tile with no gradient.
+    for (unsigned dim = 0; dim < unsigned(problem::GetShape()->NumDimensions); dim++)
+    {
+      low_problem_point[dim] += boundary.last_offset[dim];
+      high_problem_point[dim] += boundary.last_offset[dim];
+    }
+    cur_state.last_point_set = problem::OperationSpace(workload_, low_problem_point, high_problem_point);
+  }
+  else
+  {
+    std::swap(cur_state.last_point_set, point_set);
+  }
 }
 
 void NestAnalysis::ComputeSpatialWorkingSet(std::vector<analysis::LoopState>::reverse_iterator cur,
@@ -769,8 +1042,59 @@ void NestAnalysis::ComputeSpatialWorkingSet(std::vector<analysis::LoopState>::re
   // by a recursive call. Only needed to ensure correctness.
   std::vector<bool> valid_delta(num_spatial_elems, false);
 
-  FillSpatialDeltas(cur, spatial_deltas, valid_delta, 0 /* base_index */);
-  
+  if (spatial_uniformity_[level] == SpatialUniformity::Uniform)
+  {
+    // Only simulate the sentinel elements and derive the deltas of all other
+    // elements by translating element 0's delta by their operation-space
+    // offsets. The sentinels must agree with that translation.
+    FillSpatialDeltas(cur, spatial_deltas, valid_delta, 0 /* base_index */,
+                      true /* representative */);
+
+    ASSERT(valid_delta[0]);
+    auto& offsets = spatial_offsets_[level];
+    for (std::uint64_t i = 1; i < num_spatial_elems; i++)
+    {
+      problem::OperationSpace expected = spatial_deltas[0];
+      expected.Translate(offsets[i]);
+      if (valid_delta[i])
+      {
+        for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
+        {
+          if (!expected.CheckEquality(spatial_deltas[i], pv))
+          {
+            RestartNonUniform(level);
+          }
+        }
+      }
+      else
+      {
+        std::swap(spatial_deltas[i], expected);
+        valid_delta[i] = true;
+      }
+    }
+  }
+  else
+  {
+    if (parallel_spatial_level_[level])
+    {
+      ParallelFillSpatialDeltas(cur, spatial_deltas, valid_delta);
+    }
+    else
+    {
+      FillSpatialDeltas(cur, spatial_deltas, valid_delta, 0 /* base_index */);
+    }
+
+    if (spatial_uniformity_[level] == SpatialUniformity::Unverified)
+    {
+      // The state of the non-sentinel elements is already gone.
+      if (!VerifySpatialUniformity(level, spatial_deltas))
+      {
+        RestartNonUniform(level);
+      }
+      spatial_uniformity_[level] = SpatialUniformity::Uniform;
+    }
+  }
+
   // Check if each element of spatial_deltas was updated by recursive calls.
   for (auto it : valid_delta)
   {
@@ -801,47 +1125,24 @@ void NestAnalysis::ComputeSpatialWorkingSet(std::vector<analysis::LoopState>::re
     unaccounted_delta[i].fill(true);
   }
 
-  // auto& cur_state = cur->live_state[spatial_id_];
-  //  auto& accesses = nest_state_[cur->level].live_state[spatial_id_].accesses;
-  auto& cur_state = nest_state_[cur->level].live_state[spatial_id_];
+  auto& cur_state = GetElementState(cur->level, spatial_id_);
 
-  problem::PerDataSpace<std::vector<std::uint64_t>>
+  problem::PerDataSpace<tiling::MulticastHistogram<std::uint64_t>>
     accesses_without_link_transfers, accesses_with_link_transfers,
     scatter_factors_without_link_transfers, scatter_factors_with_link_transfers;
 
-   problem::PerDataSpace<std::vector<double>>
+   problem::PerDataSpace<tiling::MulticastHistogram<double>>
     cumulative_hops_without_link_transfers, cumulative_hops_with_link_transfers;
 
-  problem::PerDataSpace<std::vector<std::uint64_t>*>
+  problem::PerDataSpace<tiling::MulticastHistogram<std::uint64_t>*>
     accesses, scatter_factors;
 
-   problem::PerDataSpace<std::vector<double>*>
+   problem::PerDataSpace<tiling::MulticastHistogram<double>*>
        cumulative_hops;
 
   
   for (unsigned pvi = 0; pvi < problem::GetShape()->NumDataSpaces; pvi++)
   {
-    accesses_without_link_transfers[pvi].resize(cur_state.accesses[pvi].size());
-    accesses_with_link_transfers[pvi].resize(cur_state.accesses[pvi].size());
-    
-    scatter_factors_without_link_transfers[pvi].resize(cur_state.accesses[pvi].size());
-    scatter_factors_with_link_transfers[pvi].resize(cur_state.accesses[pvi].size());
-    
-    cumulative_hops_without_link_transfers[pvi].resize(cur_state.accesses[pvi].size());
-    cumulative_hops_with_link_transfers[pvi].resize(cur_state.accesses[pvi].size());
-    
-    for (unsigned i = 0; i < accesses_without_link_transfers[pvi].size(); i++)
-    {
-      accesses_without_link_transfers[pvi][i] = 0;
-      accesses_with_link_transfers[pvi][i] = 0;
-
-      scatter_factors_without_link_transfers[pvi][i] = 0;
-      scatter_factors_with_link_transfers[pvi][i] = 0;
-      
-      cumulative_hops_without_link_transfers[pvi][i] = 0;
-      cumulative_hops_with_link_transfers[pvi][i] = 0;
-    }
-
     // Default: do not use link transfers.
     accesses[pvi] = &accesses_without_link_transfers[pvi];
     scatter_factors[pvi] = &scatter_factors_without_link_transfers[pvi];
@@ -889,25 +1190,21 @@ void NestAnalysis::ComputeSpatialWorkingSet(std::vector<analysis::LoopState>::re
       // if (problem::Shape::DataSpaceID(pvi) == problem::Shape::DataSpaceID::Weight)
       // {
       //   std::cout << "ACCESSES *WITH* LINK TRANSFERS\n";
-      //   for (unsigned i = 0; i < accesses_with_link_transfers[pvi].size(); i++)
+      //   for (auto& entry : accesses_with_link_transfers[pvi])
       //   {
-      //     std::cout << "  " << i << ": " << accesses_with_link_transfers[pvi][i]
-      //               << ", scatter: " << scatter_factors_with_link_transfers[pvi][i] << std::endl;
+      //     std::cout << "  " << entry.first << ": " << entry.second
+      //               << ", scatter: " << scatter_factors_with_link_transfers[pvi].Get(entry.first) << std::endl;
       //   }
       //   std::cout << "ACCESSES *WITHOUT* LINK TRANSFERS\n";
-      //   for (unsigned i = 0; i < accesses_without_link_transfers[pvi].size(); i++)
+      //   for (auto& entry : accesses_without_link_transfers[pvi])
       //   {
-      //     std::cout << "  " << i << ": " << accesses_without_link_transfers[pvi][i]
-      //               << ", scatter: " << scatter_factors_without_link_transfers[pvi][i] << std::endl;
+      //     std::cout << "  " << entry.first << ": " << entry.second
+      //               << ", scatter: " << scatter_factors_without_link_transfers[pvi].Get(entry.first) << std::endl;
       //   }
       // }
       
-      std::uint64_t total_without = std::accumulate(accesses_without_link_transfers[pvi].begin(),
-                                                    accesses_without_link_transfers[pvi].end(),
-                                                    static_cast<std::uint64_t>(0));
-      std::uint64_t total_with = std::accumulate(accesses_with_link_transfers[pvi].begin(),
-                                                 accesses_with_link_transfers[pvi].end(),
-                                                 static_cast<std::uint64_t>(0));
+      std::uint64_t total_without = accesses_without_link_transfers[pvi].Total();
+      std::uint64_t total_with = accesses_with_link_transfers[pvi].Total();
       if (total_with < total_without)
       {
         cur_state.link_transfers[pvi] += link_transfers[pvi];
@@ -921,24 +1218,27 @@ void NestAnalysis::ComputeSpatialWorkingSet(std::vector<analysis::LoopState>::re
 
   for (unsigned pvi = 0; pvi < problem::GetShape()->NumDataSpaces; pvi++)
   {
-    for (unsigned i = 0; i < cur_state.accesses[pvi].size(); i++)
+    for (auto& entry : *accesses[pvi])
     {
-      cur_state.accesses[pvi][i] += (*accesses[pvi])[i];
-        
+      auto multicast_factor = entry.first;
+
       // Careful: overwriting scatter factor. The multicast/scatter signature must
       // either be un-initialized, or the accesses must be 0 (special case), or
       // it must match with the updated signature.
-      if ((*accesses[pvi])[i] > 0)
+      if (entry.second > 0)
       {
-        if (cur_state.scatter_factors[pvi][i] == 0)
+        cur_state.accesses[pvi][multicast_factor] += entry.second;
+
+        auto& scatter_factor = cur_state.scatter_factors[pvi][multicast_factor];
+        if (scatter_factor == 0)
         {
-          cur_state.scatter_factors[pvi][i] = (*scatter_factors[pvi])[i];
-          cur_state.cumulative_hops[pvi][i] = (*cumulative_hops[pvi])[i];
+          scatter_factor = scatter_factors[pvi]->Get(multicast_factor);
+          cur_state.cumulative_hops[pvi][multicast_factor] = cumulative_hops[pvi]->Get(multicast_factor);
         }
         else
         {
           // ****** FIXME ****** track multiple multicast/scatter signatures.
-          assert(cur_state.scatter_factors[pvi][i] == (*scatter_factors[pvi])[i]);
+          assert(scatter_factor == scatter_factors[pvi]->Get(multicast_factor));
         }
       }
     }      
@@ -959,9 +1259,9 @@ void NestAnalysis::ComputeSpatialWorkingSet(std::vector<analysis::LoopState>::re
   for (unsigned pvi = 0; pvi < problem::GetShape()->NumDataSpaces; pvi++)
   {
     std::uint64_t fanout = 0;
-    for (unsigned i = 0; i < cur_state.accesses[pvi].size(); i++)
+    for (auto& entry : cur_state.scatter_factors[pvi])
     {
-      fanout += (i+1) * cur_state.scatter_factors[pvi][i];
+      fanout += entry.first * entry.second;
     }
     
     if (fanout != spatial_fanouts_[cur->level])
@@ -997,6 +1297,7 @@ void NestAnalysis::FillSpatialDeltas(std::vector<analysis::LoopState>::reverse_i
                                      std::vector<problem::OperationSpace>& spatial_deltas,
                                      std::vector<bool>& valid_delta,
                                      std::uint64_t base_index,
+                                     bool representative,
                                      int depth)
 {
   int level = cur->level;
@@ -1008,6 +1309,13 @@ void NestAnalysis::FillSpatialDeltas(std::vector<analysis::LoopState>::reverse_i
   // that we are currently computing the working set for.
   base_index *= cur->descriptor.end;
 
+  // In representative mode only the sentinel elements, at the first two
+  // indices of every spatial loop, are simulated; the caller derives the
+  // remaining deltas by translation.
+  int end = representative ?
+    std::min(cur->descriptor.end, cur->descriptor.start + 2 * cur->descriptor.stride) :
+    cur->descriptor.end;
+
   if (level == 0)
   {
     // std::uint64_t body_iterations = (cur->descriptor.end - cur->descriptor.start) * num_epochs_;
@@ -1021,7 +1329,7 @@ void NestAnalysis::FillSpatialDeltas(std::vector<analysis::LoopState>::reverse_i
 
     // No more recursive calls, directly update spatial_deltas.
     for (indices_[level] = cur->descriptor.start;
-         indices_[level] < cur->descriptor.end;
+         indices_[level] < end;
          indices_[level] += cur->descriptor.stride)
     {
       std::uint64_t spatial_delta_index = base_index + indices_[level];
@@ -1049,13 +1357,13 @@ void NestAnalysis::FillSpatialDeltas(std::vector<analysis::LoopState>::reverse_i
       // extrapolate the entire *vector* of spatial_deltas returned by the
       // recursive FillSpatialDeltas() call. TODO.
       for (indices_[level] = cur->descriptor.start;
-           indices_[level] < cur->descriptor.end;
+           indices_[level] < end;
            indices_[level] += cur->descriptor.stride)
       {
         ++cur;
 
         FillSpatialDeltas(cur, spatial_deltas, valid_delta,
-                          base_index + indices_[level], depth+1);
+                          base_index + indices_[level], representative, depth+1);
 
         --cur;
         cur_transform_[dim] += scale;
@@ -1070,29 +1378,63 @@ void NestAnalysis::FillSpatialDeltas(std::vector<analysis::LoopState>::reverse_i
       unsigned iterations_run = 0;
       indices_[level] = cur->descriptor.start;
 
-      unsigned iterations_to_run = gExtrapolateUniformSpatial ? 3 : num_iterations;
+      unsigned iterations_to_run = representative ? 2 :
+        gExtrapolateUniformSpatial ? 3 : num_iterations;
+
+      // While the master level is being verified, only the sentinel elements
+      // keep their state (see spatial_uniformity_).
+      bool release_state = spatial_uniformity_[level + depth] == SpatialUniformity::Unverified;
+      auto is_sentinel = [&]()
+        {
+          for (int l = level; l <= level + depth; l++)
+          {
+            auto& desc = nest_state_[l].descriptor;
+            if (indices_[l] != desc.start && indices_[l] != desc.start + desc.stride)
+              return false;
+          }
+          return true;
+        };
+
+      // Parallel workers only simulate the elements in their range of the
+      // master level they were assigned (at depth 0 of this traversal).
+      auto in_task = [&](std::uint64_t spatial_delta_index)
+        {
+          return level + depth != task_level_ ||
+            (spatial_delta_index >= task_lo_ && spatial_delta_index < task_hi_);
+        };
 
       // Run iterations #0, #1, ... #iterations_to_run-1
       for (indices_[level] = cur->descriptor.start;
            indices_[level] < cur->descriptor.end && iterations_run < iterations_to_run;
            indices_[level] += cur->descriptor.stride, iterations_run++)
       {
-        ++cur;
-
         std::uint64_t spatial_delta_index = base_index + indices_[level];
         ASSERT(spatial_delta_index < spatial_deltas.size());
-        ASSERT(!valid_delta[spatial_delta_index]);
 
-        spatial_id_ = orig_spatial_id + spatial_delta_index;
-        spatial_deltas[spatial_delta_index] = ComputeDeltas(cur);
-        valid_delta[spatial_delta_index] = true;
+        if (in_task(spatial_delta_index))
+        {
+          ++cur;
 
-        --cur;
+          ASSERT(!valid_delta[spatial_delta_index]);
+
+          spatial_id_ = orig_spatial_id + spatial_delta_index;
+          ComputeDeltas(cur->level);
+          std::swap(spatial_deltas[spatial_delta_index], deltas_[cur->level]);
+          valid_delta[spatial_delta_index] = true;
+
+          if (release_state && !is_sentinel())
+          {
+            ReleaseElementState(level + depth, spatial_id_);
+          }
+
+          --cur;
+        }
         cur_transform_[dim] += scale;
       }
 
-      // Extrapolate all other iterations.
-      if (iterations_run < num_iterations)
+      // Extrapolate all other iterations. Task ranges are aligned to whole
+      // extrapolated loops, so checking the first element suffices.
+      if (iterations_run < num_iterations && !representative && in_task(base_index))
       {
         // Determine translation vector from #iterations_to_run-2 to #iterations_to_run-1.
         std::vector<Point> translation_vectors;
@@ -1138,14 +1480,215 @@ void NestAnalysis::FillSpatialDeltas(std::vector<analysis::LoopState>::reverse_i
   } // level > 0  
 }
 
+// Splits FillSpatialDeltas() for a master spatial level across the worker
+// analyses. Each task covers a contiguous range of spatial elements and owns
+// the element states of their subtrees while it runs.
+void NestAnalysis::ParallelFillSpatialDeltas(std::vector<analysis::LoopState>::reverse_iterator cur,
+                                             std::vector<problem::OperationSpace>& spatial_deltas,
+                                             std::vector<bool>& valid_delta)
+{
+  int level = cur->level;
+  std::uint64_t num_elems = spatial_deltas.size();
+  std::uint64_t unit = parallel_task_unit_[level];
+  std::uint64_t num_units = num_elems / unit;
+  std::uint64_t num_tasks = std::min<std::uint64_t>(spatial_workers_.size(), num_units);
+  ASSERT(num_tasks > 0);
+
+  // Element states below this level are keyed by spatial id. The subtree of
+  // element i owns ids [(spatial_id_ + i) * key_scale[l], (spatial_id_ + i + 1) * key_scale[l])
+  // at level l, where key_scale[l] is the product of the fanouts of the
+  // master spatial levels strictly between l and this level.
+  std::vector<std::uint64_t> key_scale(level, 1);
+  std::uint64_t scale = 1;
+  for (int l = level - 1; l >= 0; l--)
+  {
+    key_scale[l] = scale;
+    if (master_spatial_level_[l])
+    {
+      scale *= spatial_fanouts_[l];
+    }
+  }
+  auto has_live_state = [&](int l)
+    {
+      return !loop::IsSpatial(nest_state_[l].descriptor.spacetime_dimension) || master_spatial_level_[l];
+    };
+
+  std::vector<std::vector<bool>> task_valid(num_tasks);
+  auto body_accesses = body_info_.accesses;
+
+  for (std::uint64_t t = 0; t < num_tasks; t++)
+  {
+    auto& worker = *spatial_workers_[t];
+    worker.task_level_ = level;
+    worker.task_lo_ = (num_units * t / num_tasks) * unit;
+    worker.task_hi_ = (num_units * (t + 1) / num_tasks) * unit;
+
+    for (int l = 0; l < level; l++)
+    {
+      if (!has_live_state(l))
+      {
+        continue;
+      }
+      auto& live_state = nest_state_[l].live_state;
+      auto& worker_state = worker.nest_state_[l].live_state;
+      for (std::uint64_t id = (spatial_id_ + worker.task_lo_) * key_scale[l];
+           id < (spatial_id_ + worker.task_hi_) * key_scale[l]; id++)
+      {
+        auto it = live_state.find(id);
+        if (it != live_state.end())
+        {
+          worker_state.emplace(id, std::move(it->second));
+          live_state.erase(it);
+        }
+      }
+    }
+
+    worker.indices_ = indices_;
+    worker.cur_transform_ = cur_transform_;
+    worker.spatial_id_ = spatial_id_;
+    worker.num_epochs_ = num_epochs_;
+    worker.spatial_uniformity_ = spatial_uniformity_;
+    worker.body_info_ = body_info_;
+    worker.budget_ = budget_;
+    worker.analysis_start_ = analysis_start_;
+    worker.level_visits_ = level_visits_;
+    worker.abort_reason_ = AbortReason::None;
+    worker.restart_ = false;
+    task_valid[t].assign(num_elems, false);
+  }
+
+  std::function<void(std::size_t)> run_task = [&](std::size_t t)
+    {
+      auto& worker = *spatial_workers_[t];
+      auto worker_cur = worker.nest_state_.rbegin() + (cur - nest_state_.rbegin());
+      try
+      {
+        worker.FillSpatialDeltas(worker_cur, spatial_deltas, task_valid[t], 0 /* base_index */);
+      }
+      catch (EvalAborted&)
+      {
+        // Reported through the worker's abort reason or restart flag.
+      }
+    };
+
+  spatial_task_pool_.Run(num_tasks, run_task);
+
+  // Reduce in task order.
+  AbortReason abort_reason = AbortReason::None;
+  auto start_visits = level_visits_;
+  for (std::uint64_t t = 0; t < num_tasks; t++)
+  {
+    auto& worker = *spatial_workers_[t];
+    if (abort_reason == AbortReason::None)
+    {
+      abort_reason = worker.abort_reason_;
+    }
+    level_visits_ += worker.level_visits_ - start_visits;
+    body_info_.accesses += worker.body_info_.accesses - body_accesses;
+
+    for (int l = 0; l < level; l++)
+    {
+      if (!has_live_state(l))
+      {
+        continue;
+      }
+      auto& live_state = nest_state_[l].live_state;
+      for (auto& elem : worker.nest_state_[l].live_state)
+      {
+        live_state.emplace(elem.first, std::move(elem.second));
+      }
+      worker.nest_state_[l].live_state.clear();
+    }
+
+    for (std::uint64_t i = worker.task_lo_; i < worker.task_hi_; i++)
+    {
+      ASSERT(!valid_delta[i]);
+      valid_delta[i] = task_valid[t][i];
+    }
+  }
+
+  // Inner levels verified during this invocation take the verdict of the
+  // task holding element 0, whose subtree a serial traversal visits first,
+  // unless any task found them non-uniform.
+  bool restart = false;
+  for (int l = 0; l < level; l++)
+  {
+    spatial_uniformity_[l] = spatial_workers_[0]->spatial_uniformity_[l];
+  }
+  for (std::uint64_t t = 0; t < num_tasks; t++)
+  {
+    auto& worker = *spatial_workers_[t];
+    if (!worker.restart_)
+    {
+      continue;
+    }
+    restart = true;
+    for (int l = 0; l < level; l++)
+    {
+      if (worker.spatial_uniformity_[l] == SpatialUniformity::NonUniform)
+      {
+        spatial_uniformity_[l] = SpatialUniformity::NonUniform;
+      }
+    }
+  }
+
+  if (abort_reason != AbortReason::None)
+  {
+    Abort(abort_reason);
+  }
+  if (restart)
+  {
+    restart_ = true;
+    throw EvalAborted();
+  }
+  if (budget_.max_level_visits > 0 && level_visits_ > budget_.max_level_visits)
+  {
+    Abort(AbortReason::BudgetExceeded);
+  }
+}
+
+// Checks whether the deltas of all spatial elements fed by a master spatial
+// level are translations of element 0's delta by the elements' offsets in the
+// operation space. If so, it is safe to simulate only element 0 for the rest
+// of this analysis.
+bool NestAnalysis::VerifySpatialUniformity(
+    int level, const std::vector<problem::OperationSpace>& spatial_deltas)
+{
+  if (!gSimulateRepresentativeElement || !gExtrapolateUniformSpatial)
+  {
+    return false;
+  }
+
+  auto& offsets = spatial_offsets_[level];
+  if (offsets.size() != spatial_deltas.size())
+  {
+    return false;
+  }
+
+  for (std::uint64_t i = 1; i < spatial_deltas.size(); i++)
+  {
+    problem::OperationSpace expected = spatial_deltas[0];
+    expected.Translate(offsets[i]);
+    for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
+    {
+      if (!expected.CheckEquality(spatial_deltas[i], pv))
+      {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
 // Exhaustively compare all pairs of deltas and infer multicast opportunities.
 void NestAnalysis::ComputeAccurateMulticastedAccesses(
     std::vector<analysis::LoopState>::reverse_iterator cur,
     const std::vector<problem::OperationSpace>& spatial_deltas,
     std::vector<problem::PerDataSpace<bool>>& unaccounted_delta,
-    problem::PerDataSpace<std::vector<std::uint64_t>>& accesses,
-    problem::PerDataSpace<std::vector<std::uint64_t>>& scatter_factors,
-    problem::PerDataSpace<std::vector<double>>& cumulative_hops)
+    problem::PerDataSpace<tiling::MulticastHistogram<std::uint64_t>>& accesses,
+    problem::PerDataSpace<tiling::MulticastHistogram<std::uint64_t>>& scatter_factors,
+    problem::PerDataSpace<tiling::MulticastHistogram<double>>& cumulative_hops)
 {
   std::uint64_t num_deltas = spatial_deltas.size();
 
@@ -1215,8 +1758,8 @@ void NestAnalysis::ComputeAccurateMulticastedAccesses(
     {
       if (num_matches[pv] > 0)
       {
-        accesses[pv][num_matches[pv] - 1] += (spatial_deltas[i].GetSize(pv) * num_epochs_);
-        scatter_factors[pv][num_matches[pv] - 1]++;
+        accesses[pv][num_matches[pv]] += (spatial_deltas[i].GetSize(pv) * num_epochs_);
+        scatter_factors[pv][num_matches[pv]]++;
 
         // Compute the average number of hops from the edge of the array
         // (at this level) to the nodes in the match set.
@@ -1244,7 +1787,7 @@ void NestAnalysis::ComputeAccurateMulticastedAccesses(
 
         // Accumulate this into the running hop count. We'll finally divide this
         // by the scatter factor to get average hop count.
-        cumulative_hops[pv][num_matches[pv] - 1] += hops;
+        cumulative_hops[pv][num_matches[pv]] += hops;
       }
     }
   }
@@ -1310,7 +1853,7 @@ void NestAnalysis::ComputeNetworkLinkTransfers(
       return linearIndex;
     };
 
-  auto& cur_state = cur->live_state[spatial_id_];
+  auto& cur_state = GetElementState(cur->level, spatial_id_);
   auto& prev_spatial_deltas = cur_state.prev_point_sets[0];
   ASSERT(cur_spatial_deltas.size() == prev_spatial_deltas.size());
   int num_spatial_elems = spatial_fanouts_[cur->level];
@@ -1593,6 +2136,231 @@ void NestAnalysis::InitPerLevelDimScales()
   }
 }
 
+// Computes, for each master spatial level, the operation-space offset of each
+// spatial element relative to element 0. Spatial element ids are assigned in
+// mixed radix over the ends of the spatial loops below the master level
+// (see FillSpatialDeltas), with the master level being most significant.
+void NestAnalysis::InitSpatialOffsets()
+{
+  spatial_offsets_.clear();
+  spatial_offsets_.resize(nest_state_.size());
+
+  if (!gSimulateRepresentativeElement || !gExtrapolateUniformSpatial)
+  {
+    return;
+  }
+
+  for (int master_level = 0; master_level < int(nest_state_.size()); master_level++)
+  {
+    if (!master_spatial_level_[master_level])
+    {
+      continue;
+    }
+
+    // Spatial levels fed by this master level, outermost first.
+    std::vector<int> spatial_levels;
+    std::uint64_t num_elems = 1;
+    bool dense = true;
+    for (int level = master_level;
+         level >= 0 && loop::IsSpatial(nest_state_[level].descriptor.spacetime_dimension);
+         level--)
+    {
+      auto& desc = nest_state_[level].descriptor;
+      dense = dense && desc.start == 0 && desc.stride == 1;
+      num_elems *= desc.end;
+      spatial_levels.push_back(level);
+    }
+
+    // Leave the offsets empty (i.e., never simulate a representative) if
+    // the element ids don't map densely onto the fanout.
+    if (!dense || num_elems != spatial_fanouts_[master_level])
+    {
+      continue;
+    }
+
+    auto& offsets = spatial_offsets_[master_level];
+    offsets.resize(num_elems);
+    for (std::uint64_t id = 0; id < num_elems; id++)
+    {
+      std::uint64_t residue = id;
+      for (auto level = spatial_levels.rbegin(); level != spatial_levels.rend(); level++)
+      {
+        auto& desc = nest_state_[*level].descriptor;
+        int dim = int(desc.dimension);
+        offsets[id][dim] += per_level_dim_scales_[*level][dim] * (residue % desc.end);
+        residue /= desc.end;
+      }
+    }
+  }
+}
+
+void NestAnalysis::InitParallelSpatialLevels()
+{
+  parallel_spatial_level_.assign(nest_state_.size(), false);
+  parallel_task_unit_.assign(nest_state_.size(), 1);
+
+  if (gSpatialTaskThreads <= 1)
+  {
+    return;
+  }
+
+  for (int master_level = 0; master_level < int(nest_state_.size()); master_level++)
+  {
+    if (!master_spatial_level_[master_level] ||
+        spatial_fanouts_[master_level] < kMinParallelSpatialElems)
+    {
+      continue;
+    }
+
+    // Find the innermost spatial level fed by this master level. It must have
+    // a temporal child (otherwise there is no subtree to simulate), and the
+    // element ids must cover the fanout exactly.
+    int innermost = master_level;
+    std::uint64_t num_elems = nest_state_[master_level].descriptor.end;
+    while (innermost > 0 && loop::IsSpatial(nest_state_[innermost-1].descriptor.spacetime_dimension))
+    {
+      innermost--;
+      num_elems *= nest_state_[innermost].descriptor.end;
+    }
+    if (innermost == 0 || num_elems != spatial_fanouts_[master_level])
+    {
+      continue;
+    }
+
+    // Extrapolated innermost loops are derived from their first iterations,
+    // so they cannot be split.
+    std::uint64_t unit = gExtrapolateUniformSpatial ? nest_state_[innermost].descriptor.end : 1;
+    if (num_elems / unit >= 2)
+    {
+      parallel_spatial_level_[master_level] = true;
+      parallel_task_unit_[master_level] = unit;
+    }
+  }
+}
+
+// With extrapolation, an invocation of temporal level L invokes its child at
+// its own position and then once more (epochs scaled by n_L - 1) one step
+// u_L further along its dimension. A storage boundary k below L is thus
+// invoked at the corners of a binary counter over the levels in (k, L] with
+// n_j >= 2, in counting order. Every invocation but the first moves the
+// boundary's tile by v_j = u_j - (sum of u_i for counted i in (k, j)), where
+// j is the lowest bit set, and is weighted by the product of n_i - 1 over
+// the bits set. Summing over the counter, the fills per epoch after the
+// first delta are
+//
+//   sum over j in (k, L] of (n_j - 1) * (product of n_i for i in (j, L]) * |delta(v_j)|
+//
+// For affine projections the delta of a translation does not depend on
+// where the tile is. It also does not depend on the point set's gradient
+// history if, in every data space, the translated tile is either identical
+// to or disjoint from the original. Levels whose steps all pass that test
+// use the closed form; from the first step that does not (e.g., a sliding
+// window with a halo), this and all outer levels fall back to the walk.
+void NestAnalysis::InitClosedFormLevels()
+{
+  closed_form_level_.assign(nest_state_.size(), false);
+  closed_form_body_iterations_.assign(nest_state_.size(), 1);
+  closed_form_boundaries_.assign(nest_state_.size(), {});
+
+  if (!gClosedFormTemporal)
+  {
+    return;
+  }
+
+  // Boundary levels can only be summarized for the extrapolated schedule,
+  // and not while their delta histograms are being collected.
+  bool closed_form_boundaries = gExtrapolateUniformTemporal && !gCollectDeltaHistograms;
+
+  // Product of the trip counts of all levels below each level, and the
+  // storage boundaries below it, as long as the sub-nest stays temporal.
+  std::uint64_t inner_iterations = 1;
+  std::vector<ClosedFormBoundary> boundaries;
+  std::vector<problem::PerDataSpace<std::size_t>> boundary_sizes;
+  for (int level = 0; level < int(nest_state_.size()); level++)
+  {
+    auto& desc = nest_state_[level].descriptor;
+    if (loop::IsSpatial(desc.spacetime_dimension))
+    {
+      break;
+    }
+
+    std::uint64_t num_iterations = 1 + ((desc.end - 1 - desc.start) / desc.stride);
+    int dim = int(desc.dimension);
+
+    bool closed_form = true;
+    for (unsigned b = 0; b < boundaries.size() && closed_form; b++)
+    {
+      auto& boundary = boundaries[b];
+      for (auto& fills : boundary.fills)
+      {
+        fills *= num_iterations;
+      }
+      if (num_iterations < 2)
+      {
+        continue;
+      }
+
+      // Tile of the boundary level at the origin, and after this level's step.
+      auto low = mold_low_[boundary.level];
+      auto high = mold_high_[boundary.level];
+      problem::OperationSpace origin(workload_, low, high);
+      for (unsigned d = 0; d < unsigned(problem::GetShape()->NumDimensions); d++)
+      {
+        Coordinate step = -boundary.last_offset[d];
+        if (int(d) == dim)
+        {
+          step += per_level_dim_scales_[level][d];
+        }
+        low[d] += step;
+        high[d] += step;
+      }
+      problem::OperationSpace moved(workload_, low, high);
+      auto delta_sizes = (moved - origin).GetSizes();
+
+      for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
+      {
+        if (delta_sizes[pv] != 0 && delta_sizes[pv] != boundary_sizes[b][pv])
+        {
+          closed_form = false;
+          break;
+        }
+        boundary.fills[pv] += (num_iterations - 1) * delta_sizes[pv];
+      }
+      boundary.last_offset[dim] += per_level_dim_scales_[level][dim];
+      boundary.moved = true;
+    }
+
+    if (!closed_form)
+    {
+      break;
+    }
+
+    if (level > 0)
+    {
+      closed_form_level_[level] = true;
+      closed_form_body_iterations_[level] = inner_iterations;
+      closed_form_boundaries_[level] = boundaries;
+    }
+
+    if (storage_boundary_level_[level])
+    {
+      if (!closed_form_boundaries)
+      {
+        break;
+      }
+      ClosedFormBoundary boundary;
+      boundary.level = level;
+      boundary.fills.fill(0);
+      boundary.moved = false;
+      boundaries.push_back(boundary);
+      boundary_sizes.push_back(
+        problem::OperationSpace(workload_, mold_low_[level], mold_high_[level]).GetSizes());
+    }
+
+    inner_iterations *= num_iterations;
+  }
+}
+
 // Transform an index to a problem point.
 
 // arm: This routine is called a lot of times (no. of MACs in CONV layer),
@@ -1734,12 +2502,12 @@ void NestAnalysis::ComputeApproxMulticastedAccesses(
   }
 
   // compute and update the number of accesses at various multicast factors.
-  auto& accesses = nest_state_[master_level].live_state[spatial_id_].accesses;
+  auto& accesses = GetElementState(master_level, spatial_id_).accesses;
   for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
   {
-    ASSERT(accesses[pv].size() == spatial_deltas.size());
+    ASSERT(multicast_factors[pv] <= spatial_deltas.size());
     ASSERT(summed_deltas[pv] % multicast_factors[pv] == 0);
-    accesses[pv][multicast_factors[pv] - 1] +=
+    accesses[pv][multicast_factors[pv]] +=
         (summed_deltas[pv] / multicast_factors[pv] * num_epochs_);
   }
 }
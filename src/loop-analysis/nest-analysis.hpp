@@ -27,12 +27,44 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <limits>
+#include <memory>
+
 #include "mapping/nest.hpp"
+#include "loop-analysis/task-pool.hpp"
 #include "workload/per-problem-dimension.hpp"
 
 namespace analysis
 {
 
+// Limits on the work a single nest analysis may do; a zero limit is
+// unlimited. The optional cancellation token may be set by another thread
+// to abort an analysis in flight.
+struct EvalBudget
+{
+  double max_seconds = 0;               // wall-clock time.
+  std::uint64_t max_level_visits = 0;   // loop-level invocations.
+  const std::atomic<bool>* cancel = nullptr;
+};
+
+enum class AbortReason
+{
+  None,
+  Cancelled,
+  BudgetExceeded
+};
+
+// Thrown out of the nest traversal when an analysis is aborted. The reason
+// is available from NestAnalysis::GetAbortReason().
+class EvalAborted : public std::exception
+{
+ public:
+  const char* what() const noexcept override { return "nest analysis aborted"; }
+};
+
 class NestAnalysis
 {
  private:
@@ -46,6 +78,27 @@ class NestAnalysis
   std::vector<analysis::LoopState> nest_state_;
   std::vector<int> indices_;
   std::uint64_t num_epochs_;
+
+  // Explicit traversal state for one invocation of a temporal loop level.
+  // A level has at most one live invocation at any time, so frames are
+  // preallocated and indexed by level.
+  struct TraversalFrame
+  {
+    analysis::ElementState* state = nullptr;
+    std::uint64_t num_iterations = 0;
+    unsigned phase = 0;             // position in the iteration schedule
+    std::uint64_t step_scale = 1;   // iterations covered by the running step
+    std::uint64_t saved_epochs = 1;
+    Coordinate saved_transform = 0;
+    std::vector<problem::PerDataSpace<std::size_t>> temporal_delta_sizes;
+    std::vector<std::uint64_t> temporal_delta_scale;
+  };
+  std::vector<TraversalFrame> frames_;
+
+  // Per-level scratch point sets, and the delta most recently produced
+  // by each level (consumed by the next-outer level).
+  std::vector<problem::OperationSpace> point_sets_;
+  std::vector<problem::OperationSpace> deltas_;
   
   // Identifies the spatial element
   // whose working set is currently being computed.
@@ -85,10 +138,73 @@ class NestAnalysis
   // level are connected by on-chip links.
   std::vector<bool> linked_spatial_level_;
 
+  // Representative-element simulation. Only the sentinel elements of a
+  // master spatial level (the first two indices of every spatial loop it
+  // feeds) keep live state. On its first invocation the level simulates
+  // every element, dropping the state of each non-sentinel element as soon
+  // as its delta is known, and checks that every delta is a pure translation
+  // of element 0's. Once verified uniform, invocations simulate only the
+  // sentinels, check them against element 0 again, and derive the other
+  // elements by translation. A failed check marks the level non-uniform and
+  // restarts the analysis, which then keeps the full state of that level.
+  enum class SpatialUniformity { Unverified, Uniform, NonUniform };
+  std::vector<SpatialUniformity> spatial_uniformity_;
+  bool restart_ = false;
+
+  // Per master spatial level: the operation-space offset of each spatial
+  // element relative to element 0 (empty if it cannot be derived).
+  std::vector<std::vector<problem::OperationPoint>> spatial_offsets_;
+
+  // Temporal levels whose entire sub-nest is temporal and whose storage
+  // boundaries see no halo: at every step of the extrapolated schedule, each
+  // data space's tile either stays put or moves to a disjoint location. The
+  // sub-nest of such a level is not walked. The compute (level 0) accesses
+  // are the product of the inner trip counts (closed_form_body_iterations_),
+  // and each boundary below contributes its first delta, computed against
+  // its live state, plus a constant number of fills per epoch.
+  struct ClosedFormBoundary
+  {
+    int level;
+    // Fills per epoch after the first delta, per data space.
+    problem::PerDataSpace<std::uint64_t> fills;
+    // Where the boundary's last invocation sits relative to the first.
+    problem::OperationPoint last_offset;
+    bool moved;
+  };
+  std::vector<bool> closed_form_level_;
+  std::vector<std::uint64_t> closed_form_body_iterations_;
+  std::vector<std::vector<ClosedFormBoundary>> closed_form_boundaries_;
+
+  // Parallel simulation of large master spatial levels that cannot use a
+  // representative element. Each worker is a copy of this analysis that
+  // simulates a contiguous range [task_lo_, task_hi_) of the spatial elements
+  // of master level task_level_, in units of parallel_task_unit_ elements (a whole innermost
+  // spatial loop when it is extrapolated). The element states of each
+  // range's subtrees are moved into the worker for the duration of the
+  // invocation and moved back afterwards, so results do not depend on
+  // scheduling. The tasks run on spatial_task_pool_, whose threads outlive
+  // individual invocations and analyses.
+  std::vector<bool> parallel_spatial_level_;
+  std::vector<std::uint64_t> parallel_task_unit_;
+  std::vector<std::shared_ptr<NestAnalysis>> spatial_workers_;
+  TaskPool spatial_task_pool_;
+  int task_level_ = -1;
+  std::uint64_t task_lo_ = 0;
+  std::uint64_t task_hi_ = std::numeric_limits<std::uint64_t>::max();
+
   bool working_sets_computed_ = false;
 
   problem::Workload* workload_ = nullptr;
 
+  // Budget for the current analysis, and the progress made against it. The
+  // clock and the cancellation token are only polled every
+  // kBudgetPollInterval level visits.
+  static const std::uint64_t kBudgetPollInterval = 1024;
+  EvalBudget budget_;
+  std::uint64_t level_visits_ = 0;
+  std::chrono::steady_clock::time_point analysis_start_;
+  AbortReason abort_reason_ = AbortReason::None;
+
   // Internal helper methods.
   void ComputeWorkingSets();
 
@@ -97,14 +213,30 @@ class NestAnalysis
   void InitStorageBoundaries();
   void InitSpatialFanouts();
   void InitPerLevelDimScales();
+  void InitSpatialOffsets();
+  void InitParallelSpatialLevels();
+  void InitClosedFormLevels();
 
   void InitializeLiveState();
+  analysis::ElementState& GetElementState(int level, std::uint64_t spatial_id);
+  void ReleaseElementState(int master_level, std::uint64_t element_id);
+  void RestartNonUniform(int level);
   void CollectWorkingSets();
 
   problem::OperationPoint IndexToOperationPoint_(const std::vector<int>& indices) const;
   
-  problem::OperationSpace ComputeDeltas(
-    std::vector<analysis::LoopState>::reverse_iterator cur, bool skip_delta = false);
+  void PollBudget();
+  void Abort(AbortReason reason);
+
+  void ComputeDeltas(int level);
+  void AccumulateBodyAccesses(analysis::ElementState& cur_state, std::uint64_t body_iterations);
+  void AccumulateFills(analysis::ElementState& cur_state,
+                       const problem::PerDataSpace<std::uint64_t>& fills);
+  void ComputeClosedFormBoundary(const ClosedFormBoundary& boundary);
+  void BeginLevel(int level);
+  bool BeginChildIteration(int level);
+  void EndChildIteration(int level);
+  void FinishLevel(int level);
 
   void ComputeTemporalWorkingSet(std::vector<analysis::LoopState>::reverse_iterator cur,
                                  problem::OperationSpace& point_set,
@@ -116,16 +248,23 @@ class NestAnalysis
                          std::vector<problem::OperationSpace>& spatial_deltas,
                          std::vector<bool>& valid_delta,
                          std::uint64_t base_index,
+                         bool representative = false,
                          int depth = 0);
+  void ParallelFillSpatialDeltas(std::vector<analysis::LoopState>::reverse_iterator cur,
+                                 std::vector<problem::OperationSpace>& spatial_deltas,
+                                 std::vector<bool>& valid_delta);
+
+  bool VerifySpatialUniformity(int level,
+                               const std::vector<problem::OperationSpace>& spatial_deltas);
 
   void ComputeAccurateMulticastedAccesses(
       std::vector<analysis::LoopState>::reverse_iterator cur,
       const std::vector<problem::OperationSpace>& spatial_deltas,
       std::vector<problem::PerDataSpace<bool>>&
       unaccounted_delta,
-      problem::PerDataSpace<std::vector<std::uint64_t>>& accesses,
-      problem::PerDataSpace<std::vector<std::uint64_t>>& scatter_factors,
-      problem::PerDataSpace<std::vector<double>>& cumulative_hops
+      problem::PerDataSpace<tiling::MulticastHistogram<std::uint64_t>>& accesses,
+      problem::PerDataSpace<tiling::MulticastHistogram<std::uint64_t>>& scatter_factors,
+      problem::PerDataSpace<tiling::MulticastHistogram<double>>& cumulative_hops
     );
 
   void ComputeApproxMulticastedAccesses(
@@ -144,10 +283,15 @@ class NestAnalysis
   NestAnalysis();
   void Init(problem::Workload* wc, const loop::Nest* nest);
   void Reset();
+
+  // Applies to analyses started after this call. An analysis that runs out
+  // of budget throws EvalAborted.
+  void SetBudget(const EvalBudget& budget) { budget_ = budget; }
+  AbortReason GetAbortReason() const { return abort_reason_; }
  
   std::vector<problem::PerDataSpace<std::size_t>> GetWorkingSetSizes_LTW() const;
 
-  problem::PerDataSpace<std::vector<tiling::TileInfo>> GetWorkingSets();
+  const problem::PerDataSpace<std::vector<tiling::TileInfo>>& GetWorkingSets();
   tiling::BodyInfo GetBodyInfo();
 
   // Serialization.
@@ -158,7 +158,8 @@ class AxisAlignedHyperRectangle
 
   bool empty() const
   {
-    return (size() == 0);
+    // Equivalent to size() == 0, without the products.
+    return simd::EqualMask(min_.data(), max_.data(), order_) != 0;
   }
 
   void Reset()
@@ -183,13 +184,13 @@ class AxisAlignedHyperRectangle
     ASSERT(order_ == s.order_);
     
     // Special cases.
-    if (size() == 0)
+    if (empty())
     {
       *this = s;
       return;
     }
 
-    if (s.size() == 0)
+    if (s.empty())
     {
       return;
     }
@@ -199,86 +200,58 @@ class AxisAlignedHyperRectangle
       return;
     }
 
-    auto orig = *this;
-    
     // Both AAHRs should have identical min_, max_ along all-but-one axes, and
     // must be contiguous along the but-one axis.
-    bool found = false;
-    for (unsigned dim = 0; dim < order_; dim++)
+    auto discontiguous =
+      simd::LessThanMask(s.max_.data(), min_.data(), order_) |
+      simd::LessThanMask(max_.data(), s.min_.data(), order_);
+    auto grow_low = simd::LessThanMask(s.min_.data(), min_.data(), order_);
+    auto grow_high = simd::LessThanMask(max_.data(), s.max_.data(), order_);
+
+    if (discontiguous && !extrude_if_discontiguous)
     {
-      if (s.max_[dim] >= min_[dim] && max_[dim] >= s.min_[dim])
+      std::cout << "AAHR Add error: discontiguous volumes (and extrude is disabled)\n";
+      Print(); std::cout << std::endl;
+      s.Print(); std::cout << std::endl;          
+      assert(false);
+    }
+
+    auto update = discontiguous | grow_low | grow_high;
+    if (update == 0)
+    {
+      return;
+    }
+
+    if ((update & (update - 1)) != 0)
+    {
+      std::cout << "AAHR Add error: non-HR shape\n";
+      Print(); std::cout << std::endl;
+      s.Print(); std::cout << std::endl;          
+      assert(false);
+    }
+
+    auto dim = simd::FirstLane(update);
+    if (discontiguous)
+    {
+      // Extrude.
+      if (s.max_[dim] < min_[dim])
       {
-        auto u = *this;
-        bool need_update = false;
-        
-        if (s.min_[dim] < min_[dim])
-        {
-          u.min_[dim] = s.min_[dim];
-          need_update = true;
-        }
-        if (s.max_[dim] > max_[dim])
-        {
-          u.max_[dim] = s.max_[dim];
-          need_update = true;
-        }
-        
-        if (need_update)
-        {
-          if (found)
-          {
-            std::cout << "AAHR Add error: non-HR shape\n";
-            orig.Print(); std::cout << std::endl;
-            s.Print(); std::cout << std::endl;          
-            assert(false);
-          }
-          else
-          {
-            *this = u;
-            found = true;
-          }
-        }
+        min_[dim] = s.min_[dim];
       }
       else
       {
-        if (!extrude_if_discontiguous)
-        {
-          std::cout << "AAHR Add error: discontiguous volumes (and extrude is disabled)\n";
-          orig.Print(); std::cout << std::endl;
-          s.Print(); std::cout << std::endl;          
-          assert(false);
-        }
-        else
-        {
-          auto u = *this;
-          bool need_update = false;
-        
-          if (s.max_[dim] < min_[dim])
-          {
-            u.min_[dim] = s.min_[dim];
-            need_update = true;
-          }
-          else
-          {
-            u.max_[dim] = s.max_[dim];
-            need_update = true;
-          }
-        
-          if (need_update)
-          {
-            if (found)
-            {
-              std::cout << "AAHR Add error: non-HR shape\n";
-              orig.Print(); std::cout << std::endl;
-              s.Print(); std::cout << std::endl;          
-              assert(false);
-            }
-            else
-            {
-              *this = u;
-              found = true;
-            }
-          }
-        } // extrude_if_discontiguous
+        max_[dim] = s.max_[dim];
+      }
+    }
+    else
+    {
+      if (grow_low)
+      {
+        min_[dim] = s.min_[dim];
+      }
+      if (grow_high)
+      {
+        max_[dim] = s.max_[dim];
       }
     }
   }
@@ -288,7 +261,7 @@ class AxisAlignedHyperRectangle
     ASSERT(order_ == s.order_);
     
     // Special cases.
-    if (size() == 0 || s.size() == 0)
+    if (empty() || s.empty())
     {
       return Gradient(order_);
     }
@@ -299,14 +272,14 @@ class AxisAlignedHyperRectangle
       return Gradient(order_);
     }
 
-    for (unsigned dim = 0; dim < order_; dim++)
+    auto overlap =
+      simd::LessThanMask(min_.data(), s.max_.data(), order_) &
+      simd::LessThanMask(s.min_.data(), max_.data(), order_);
+    if (overlap != simd::OrderMask(order_))
     {
-      if (s.max_[dim] <= min_[dim] || s.min_[dim] >= max_[dim])
-      {
-        // No overlap along even a single dimension means there's
-        // no intersection at all. Skip this function.
-        return Gradient(order_);
-      }
+      // No overlap along even a single dimension means there's
+      // no intersection at all. Skip this function.
+      return Gradient(order_);
     }
  
     auto updated = *this;
@@ -317,71 +290,73 @@ class AxisAlignedHyperRectangle
     // axis. If this isn't true, then torpedo everything, keep the source
     // as the result, and set gradient to 0.
     bool found = false;
-    for (unsigned dim = 0; dim < order_; dim++)
+    auto differing =
+      simd::NotEqualMask(min_.data(), s.min_.data(), order_) |
+      simd::NotEqualMask(max_.data(), s.max_.data(), order_);
+    for (; differing != 0; differing &= (differing - 1))
     {
-      if (min_[dim] != s.min_[dim] || max_[dim] != s.max_[dim])
+      unsigned dim = simd::FirstLane(differing);
+
+      if (found)
       {
-        if (found)
-        {
-          // Torpedo everything, set delta to source, gradient to 0.
-          // WARNING: this simply discards potential non-AAHR shapes,
-          // which is something we do want to do occasionally. However,
-          // there may be bugs causing non-AAHR shapes, which will be
-          // masked by this step.
-          return Gradient(order_);
-        }
-        
-        found = true;
+        // Torpedo everything, set delta to source, gradient to 0.
+        // WARNING: this simply discards potential non-AAHR shapes,
+        // which is something we do want to do occasionally. However,
+        // there may be bugs causing non-AAHR shapes, which will be
+        // masked by this step.
+        return Gradient(order_);
+      }
+      
+      found = true;
 
-        if (s.min_[dim] <= min_[dim])
+      if (s.min_[dim] <= min_[dim])
+      {
+        if (s.max_[dim] <= max_[dim])
         {
-          if (s.max_[dim] <= max_[dim])
-          {
-            gradient.dimension = dim;
-            gradient.value = s.max_[dim] - min_[dim];
-            updated.min_[dim] = s.max_[dim];
-          }
-          else
-          {
-            gradient.Reset();
-            updated.max_[dim] = min_[dim];
-          }
+          gradient.dimension = dim;
+          gradient.value = s.max_[dim] - min_[dim];
+          updated.min_[dim] = s.max_[dim];
         }
-        else if (s.min_[dim] > min_[dim])
+        else
         {
-          if (s.max_[dim] < max_[dim])
-          {
-            assert(false);
-
-            // The accuracy of the following comment is questionable. Fractures
-            // don't appear to be happening for the dataflows we've been looking
-            // at so far. We are enabling the assertion.
-            
-            // Subtraction is causing a fracture. This can happen during
-            // macro tile changes with sliding windows. Discard the operand,
-            // and return a zero gradient.
-            return Gradient(order_);
-          }
-          else
-          {
-            gradient.dimension = dim;
-            gradient.value = s.min_[dim] - max_[dim];
-            updated.max_[dim] = s.min_[dim];
-          }
+          gradient.Reset();
+          updated.max_[dim] = min_[dim];
         }
-        else
+      }
+      else if (s.min_[dim] > min_[dim])
+      {
+        if (s.max_[dim] < max_[dim])
         {
           assert(false);
-        }
 
-        // If we just shrunk the AAHR down to NULL, reset it into canonical form
-        // and skip the remainder of this function.
-        if (updated.min_[dim] == updated.max_[dim])
-        {
-          // Discard updated, we're going to Reset ourselves anyway.
-          Reset();
+          // The accuracy of the following comment is questionable. Fractures
+          // don't appear to be happening for the dataflows we've been looking
+          // at so far. We are enabling the assertion.
+          
+          // Subtraction is causing a fracture. This can happen during
+          // macro tile changes with sliding windows. Discard the operand,
+          // and return a zero gradient.
           return Gradient(order_);
         }
+        else
+        {
+          gradient.dimension = dim;
+          gradient.value = s.min_[dim] - max_[dim];
+          updated.max_[dim] = s.min_[dim];
+        }
+      }
+      else
+      {
+        assert(false);
+      }
+
+      // If we just shrunk the AAHR down to NULL, reset it into canonical form
+      // and skip the remainder of this function.
+      if (updated.min_[dim] == updated.max_[dim])
+      {
+        // Discard updated, we're going to Reset ourselves anyway.
+        Reset();
+        return Gradient(order_);
       }
     }
 
@@ -461,15 +436,10 @@ class AxisAlignedHyperRectangle
   bool operator == (const AxisAlignedHyperRectangle& s) const
   {
     ASSERT(order_ == s.order_);
-    
-    for (unsigned dim = 0; dim < order_; dim++)
-    {
-      if (min_[dim] != s.min_[dim] || max_[dim] != s.max_[dim])
-      {
-        return false;
-      }
-    }
-    return true;
+
+    auto full = simd::OrderMask(order_);
+    return simd::EqualMask(min_.data(), s.min_.data(), order_) == full &&
+           simd::EqualMask(max_.data(), s.max_.data(), order_) == full;
   }
 
   Point GetTranslation(const AxisAlignedHyperRectangle& s) const
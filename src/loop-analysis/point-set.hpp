@@ -47,6 +47,8 @@
 
 typedef std::int32_t Coordinate;
 
+#include "aahr-simd.hpp"
+
 class Point
 {
  protected:
@@ -65,7 +67,9 @@ class Point
   Point(std::uint32_t order) :
       order_(order)
   {
-    coordinates_.resize(order_);
+    // Pad the storage (with zeros) so that vectorized primitives can
+    // operate on whole registers.
+    coordinates_.resize(simd::PaddedOrder(order_));
     Reset();
   }
   
@@ -86,23 +90,28 @@ class Point
     return coordinates_[i];
   }
 
+  const Coordinate* data() const
+  {
+    return coordinates_.data();
+  }
+
   void IncrementAllDimensions(Coordinate m = 1)
   {
-    for (auto& c : coordinates_)
-      c += m;
+    for (unsigned i = 0; i < order_; i++)
+      coordinates_[i] += m;
   }
 
   void Scale(unsigned factor)
   {
-    for (auto& c : coordinates_)
-      c *= factor;
+    for (unsigned i = 0; i < order_; i++)
+      coordinates_[i] *= factor;
   }
 
   std::ostream& Print(std::ostream& out = std::cout) const
   {
     out << "[" << order_ << "]: ";
-    for (auto& c : coordinates_)
-      out << c << " ";
+    for (unsigned i = 0; i < order_; i++)
+      out << coordinates_[i] << " ";
     return out;
   }
 };
@@ -0,0 +1,142 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace analysis
+{
+
+// ---------------------------------------------------------------
+// Persistent threads for the parallel steps of an analysis.
+// ---------------------------------------------------------------
+// Run(n, task) calls task(0) on the calling thread and task(1) .. task(n-1)
+// on the pool's threads, and returns once all of them have finished.
+// Threads are started on first use and then wait for the next step, so an
+// analysis that runs a parallel step on every outer iteration does not pay
+// for thread creation each time. Copying a pool yields an empty one: the
+// threads stay with the analysis that started them.
+
+class TaskPool
+{
+ private:
+  std::vector<std::thread> threads_;
+
+  std::mutex mutex_;
+  std::condition_variable start_cv_;
+  std::condition_variable done_cv_;
+  const std::function<void(std::size_t)>* task_ = nullptr;
+  std::uint64_t generation_ = 0;
+  std::size_t num_tasks_ = 0;
+  std::size_t pending_ = 0;
+  bool stop_ = false;
+
+  void WorkerLoop(std::size_t id, std::uint64_t generation)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+      start_cv_.wait(lock, [&] { return stop_ || generation_ != generation; });
+      if (stop_)
+      {
+        return;
+      }
+      generation = generation_;
+      if (id < num_tasks_)
+      {
+        auto task = task_;
+        lock.unlock();
+        (*task)(id);
+        lock.lock();
+        if (--pending_ == 0)
+        {
+          done_cv_.notify_one();
+        }
+      }
+    }
+  }
+
+ public:
+  TaskPool() {}
+
+  TaskPool(const TaskPool&) {}
+
+  TaskPool& operator = (const TaskPool&)
+  {
+    return *this;
+  }
+
+  ~TaskPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto& thread : threads_)
+    {
+      thread.join();
+    }
+  }
+
+  void Run(std::size_t num_tasks, const std::function<void(std::size_t)>& task)
+  {
+    if (num_tasks == 0)
+    {
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      // New threads wait for the generation after the current one, i.e.,
+      // the step started below.
+      while (threads_.size() + 1 < num_tasks)
+      {
+        threads_.emplace_back(&TaskPool::WorkerLoop, this, threads_.size() + 1, generation_);
+      }
+      task_ = &task;
+      num_tasks_ = num_tasks;
+      pending_ = num_tasks - 1;
+      generation_++;
+    }
+    start_cv_.notify_all();
+
+    task(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [&] { return pending_ == 0; });
+    task_ = nullptr;
+  }
+};
+
+} // namespace analysis
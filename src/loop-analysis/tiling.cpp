@@ -26,6 +26,7 @@
  */
 
 #include <cassert>
+#include <cstring>
 #include <sstream>
 
 #include "tiling.hpp"
@@ -45,10 +46,12 @@ std::ostream& operator << (std::ostream& out, const TileInfo& info)
   out << "size = " << info.size << " accesses = " << info.GetTotalAccesses()
       << " fanout = " << info.fanout << " repfactor = " << info.replication_factor
       << " linkxfers = " << info.link_transfers << std::endl;
-  for (std::uint32_t i = 0; i < info.accesses.size(); i++)
+  for (auto& entry : info.accesses)
   {
-    out << "    [" << i << "] = " << info.accesses[i] << " @scatter = "
-        << info.scatter_factors[i] << " hops = " << info.cumulative_hops[i] << std::endl;
+    auto multicast_factor = entry.first;
+    out << "    [" << multicast_factor - 1 << "] = " << entry.second << " @scatter = "
+        << info.scatter_factors.Get(multicast_factor) << " hops = "
+        << info.cumulative_hops.Get(multicast_factor) << std::endl;
   }
   return out;
 }
@@ -63,13 +66,13 @@ uint64_t FindMulticastFactor(const TileInfo& tile)
 {
   uint64_t multicast_factor = 1;
   bool multicast_found = false;
-  for (uint64_t i = 0; i < tile.fanout; i++)
+  for (auto& entry : tile.accesses)
   {
-    if (tile.accesses[i] != 0)
+    if (entry.first <= tile.fanout && entry.second != 0)
     {
       assert(!multicast_found);
       multicast_found = true;
-      multicast_factor = i + 1;
+      multicast_factor = entry.first;
     }
   }
   assert(multicast_found);
@@ -139,9 +142,9 @@ void MaskTiles(std::vector<TileInfo>& tile_nest, std::bitset<MaxTilingLevels> ma
     
     tile_nest[outer].content_accesses = 0;
     
-    for (uint64_t i = 0; i < tile_nest[outer].fanout; i++)
+    for (auto& entry : tile_nest[outer].accesses)
     {
-      if (tile_nest[outer].accesses[i] != 0)
+      if (entry.first <= tile_nest[outer].fanout && entry.second != 0)
       {
         // The outer content (buffer) will now be accessed as frequently
         // as the inner content was. However, if the outer level had a fanout, then
@@ -152,19 +155,15 @@ void MaskTiles(std::vector<TileInfo>& tile_nest, std::bitset<MaxTilingLevels> ma
         // and max fanout is complex.
         // - FIXME 1: spatial sliding windows.
         // - FIXME 2: outer-cur > 1.
-        auto multicast_factor = i + 1;
-        auto scatter_factor = tile_nest[outer].scatter_factors[i];
+        auto multicast_factor = entry.first;
+        auto scatter_factor = tile_nest[outer].scatter_factors.Get(multicast_factor);
         
         tile_nest[outer].content_accesses +=
           tile_nest[cur].content_accesses * scatter_factor;
       
         // The outer network will now be energized as frequently as
         // the inner content was accessed.
-        tile_nest[outer].accesses[i] = 0;
-        tile_nest[outer].scatter_factors[i] = 0;
-        tile_nest[outer].accesses[multicast_factor-1] =
-          tile_nest[cur].content_accesses * scatter_factor;
-        tile_nest[outer].scatter_factors[multicast_factor-1] = scatter_factor;
+        entry.second = tile_nest[cur].content_accesses * scatter_factor;
 
         // Note: partition size for outer does not change.
       }
@@ -225,10 +224,10 @@ void DistributeTiles(std::vector<TileInfo>& tile_nest,
       // The outer tile's per-instance access count is unchanged, but its
       // multicast factor changes to 1 (effectively turning it into a
       // full scatter fanout).
-      tile_nest[outer].accesses[0] = tile_nest[outer].accesses[outer_multicast_factor-1];
-      tile_nest[outer].scatter_factors[0] = tile_nest[outer].fanout;
-      tile_nest[outer].accesses[outer_multicast_factor-1] = 0;
-      tile_nest[outer].scatter_factors[outer_multicast_factor-1] = 0;
+      tile_nest[outer].accesses[1] = tile_nest[outer].accesses.Get(outer_multicast_factor);
+      tile_nest[outer].scatter_factors[1] = tile_nest[outer].fanout;
+      tile_nest[outer].accesses[outer_multicast_factor] = 0;
+      tile_nest[outer].scatter_factors[outer_multicast_factor] = 0;
 
       // The inner tile's per-instance size, partition size and content-access count
       // reduces by the outer multicast factor. Note that this may not be a perfect
@@ -243,18 +242,14 @@ void DistributeTiles(std::vector<TileInfo>& tile_nest,
       // factor of outer_multicast_factor. These alterations will magically trigger
       // all the right computations at the model evaluation stage.
       uint64_t distributed_multicast_factor = outer_multicast_factor * inner_multicast_factor;
-      if (distributed_multicast_factor > tile_nest[inner].fanout)
-      {
-        tile_nest[inner].accesses.resize(distributed_multicast_factor);
-        tile_nest[inner].scatter_factors.resize(distributed_multicast_factor);
-      }
       tile_nest[inner].distributed_multicast = true;
       tile_nest[inner].distributed_fanout = distributed_multicast_factor * tile_nest[inner].fanout;
-      tile_nest[inner].accesses[distributed_multicast_factor-1] = 1 + 
-        (tile_nest[inner].accesses[inner_multicast_factor-1] - 1) / outer_multicast_factor;
-      tile_nest[inner].scatter_factors[distributed_multicast_factor-1] = tile_nest[inner].scatter_factors[inner_multicast_factor-1];
-      tile_nest[inner].accesses[inner_multicast_factor-1] = 0;
-      tile_nest[inner].scatter_factors[inner_multicast_factor-1] = 0;
+      tile_nest[inner].accesses[distributed_multicast_factor] = 1 + 
+        (tile_nest[inner].accesses.Get(inner_multicast_factor) - 1) / outer_multicast_factor;
+      tile_nest[inner].scatter_factors[distributed_multicast_factor] =
+        tile_nest[inner].scatter_factors.Get(inner_multicast_factor);
+      tile_nest[inner].accesses[inner_multicast_factor] = 0;
+      tile_nest[inner].scatter_factors[inner_multicast_factor] = 0;
 
       // ***** FIXME ***** make this work with PRECISE_MULTICAST, which means we
       // need to update cumulative_hops.
@@ -300,9 +295,9 @@ void ComputeFills(std::vector<TileInfo>& tile_nest)
     // std::cerr << "  outer = " << outer << std::endl;
 
     // Found an outer level.
-    for (uint64_t i = 0; i < tile_nest[outer].fanout; i++)
+    for (auto& entry : tile_nest[outer].accesses)
     {
-      if (tile_nest[outer].accesses[i] != 0)
+      if (entry.first <= tile_nest[outer].fanout && entry.second != 0)
       {
         // FIXME: is this correct in the face of spatial sliding windows (e.g. Input halos)?
         // If scatter factors are calculated on fragments, then this will be correct, because
@@ -311,13 +306,13 @@ void ComputeFills(std::vector<TileInfo>& tile_nest)
         // code compares complete temporal deltas delivered to peer spatial instances.
         // To fix this, we should be able to use the new overlap-fraction based method used to
         // calculate partition sizes in some way.
-        tile_nest[cur].fills += tile_nest[outer].accesses[i] / tile_nest[outer].scatter_factors[i];
-        // std::cerr << "    mcast = " << i+1 << std::endl;
-        // std::cerr << "      outer accesses = " << tile_nest[outer].accesses[i] << std::endl;
-        // std::cerr << "      outer scatter = " << tile_nest[outer].scatter_factors[i] << std::endl;
-        // std::cerr << "      cur fills incr = " << tile_nest[outer].accesses[i] / tile_nest[outer].scatter_factors[i] << std::endl;
+        tile_nest[cur].fills += entry.second / tile_nest[outer].scatter_factors.Get(entry.first);
+        // std::cerr << "    mcast = " << entry.first << std::endl;
+        // std::cerr << "      outer accesses = " << entry.second << std::endl;
+        // std::cerr << "      outer scatter = " << tile_nest[outer].scatter_factors.Get(entry.first) << std::endl;
+        // std::cerr << "      cur fills incr = " << entry.second / tile_nest[outer].scatter_factors.Get(entry.first) << std::endl;
         // std::cerr << "      cur upd fills = " << tile_nest[cur].fills << std::endl;
-        // std::cerr << "      cur accesses = " << tile_nest[cur].accesses[i] << std::endl;
+        // std::cerr << "      cur accesses = " << tile_nest[cur].accesses.Get(entry.first) << std::endl;
       }
     }
 
@@ -379,27 +374,33 @@ void ComputePeerAccesses(std::vector<TileInfo>& tile_nest)
   return;
 }
 // Collapse tiles into a given number of levels.
-// Input and output are both arrays of tile nests,
-// with one nest per problem::Shape::DataSpaceID.
-CompoundTileNest CollapseTiles(CompoundTileNest& tiles, int num_tiling_levels,
-                               const CompoundMaskNest& tile_mask,
-                               const CompoundMaskNest& distribution_supported)
+// Input is an array of tile nests, with one nest per problem::Shape::DataSpaceID.
+// The collapsed nests are built in buffers.collapsed and then moved (not
+// copied) into buffers.tiles in level->data-space order.
+void CollapseTiles(const CompoundTileNest& tiles, int num_tiling_levels,
+                   const CompoundMaskNest& tile_mask,
+                   const CompoundMaskNest& distribution_supported,
+                   TilePipelineBuffers& buffers)
 {
   // Constructing an array of tile nests, one for each problem::Shape::DataSpaceID.
   // From the tile data, select the size and accesses at the boundaries of each
   // storage level. Size comes from the outermost tile within the storage level,
   // and accesses comes from the innermost tile within the storage level.
-  CompoundTileNest solution;
+  auto& solution = buffers.collapsed;
   for (int pv = 0; pv < int(problem::GetShape()->NumDataSpaces); pv++)
   {
+    solution[pv].resize(num_tiling_levels);
+
     int processed_loop_count = 0;  // number of loops that have been collapsed
     int cur_tiling_level = 0;
     int total_loops = tiles[pv].size();
 
     while (processed_loop_count < total_loops)
     {
-      // Form a new physical tiling level.
-      TileInfo collapsed_tile;
+      // Form a new physical tiling level, recycling the buffer's storage.
+      assert(cur_tiling_level < num_tiling_levels);
+      TileInfo& collapsed_tile = solution[pv][cur_tiling_level];
+      collapsed_tile.Reset();
 
       // Find the last loop that belongs to the current tile.
       int boundary_loop_id = processed_loop_count;
@@ -437,9 +438,9 @@ CompoundTileNest CollapseTiles(CompoundTileNest& tiles, int num_tiling_levels,
       collapsed_tile.replication_factor = tiles[pv][outermost_loop].replication_factor;
       collapsed_tile.fanout = tiles[pv][innermost_loop].fanout;
 
-      if (!solution[pv].empty())
+      if (cur_tiling_level > 0)
       {
-        auto& inner_tile = solution[pv].back();
+        auto& inner_tile = solution[pv][cur_tiling_level - 1];
 
         inner_tile.partition_fraction_denominator =
           tiles[pv][innermost_loop].is_master_spatial ?
@@ -447,8 +448,6 @@ CompoundTileNest CollapseTiles(CompoundTileNest& tiles, int num_tiling_levels,
           inner_tile.size;
       }
 
-      solution[pv].push_back(collapsed_tile);
-
       processed_loop_count = boundary_loop_id + 1;
       cur_tiling_level++;
     }
@@ -468,54 +467,138 @@ CompoundTileNest CollapseTiles(CompoundTileNest& tiles, int num_tiling_levels,
 
     // Calculate the extra accesses and fills due to link transfers
     ComputePeerAccesses(solution[pv]);
-
   }
-  return solution;
-}
 
-// Collapse with default tile mask.
-// CompoundTileNest CollapseTiles(CompoundTileNest& tiles, int num_tiling_levels)
-// {
-//   std::bitset<MaxTilingLevels> all_ones;
-//   all_ones.set();
-//   CompoundMaskNest all_enabled;
-//   all_enabled.fill(all_ones);
-//   return CollapseTiles(tiles, num_tiling_levels, all_enabled);
-// }
-
-NestOfCompoundTiles TransposeTiles(const CompoundTileNest & tiles)
-{
-  NestOfCompoundTiles retval;
-  
-  std::size_t num_levels = tiles[0].size();
-  for (std::size_t level = 0; level < num_levels; level++)
+  // Transpose into level->datatype structure. Swapping hands the previous
+  // result's storage back to the scratch nests for the next evaluation.
+  buffers.tiles.resize(num_tiling_levels);
+  for (int level = 0; level < num_tiling_levels; level++)
   {
-    CompoundTile tile_level;
     for (int pv = 0; pv < int(problem::GetShape()->NumDataSpaces); pv++)
     {
-      tile_level[pv] = tiles[pv][level];
+      std::swap(buffers.tiles[level][pv], solution[pv][level]);
     }
-    retval.push_back(tile_level);
   }
-
-  return retval;
 }
 
 NestOfCompoundMasks TransposeMasks(const CompoundMaskNest& masks)
 {
   NestOfCompoundMasks retval;
-  
+  TransposeMasks(masks, retval);
+  return retval;
+}
+
+void TransposeMasks(const CompoundMaskNest& masks, NestOfCompoundMasks& transposed)
+{
+  transposed.resize(MaxTilingLevels);
   for (std::size_t level = 0; level < MaxTilingLevels; level++)
   {
-    CompoundMask mask_level;
     for (int pv = 0; pv < int(problem::GetShape()->NumDataSpaces); pv++)
     {
-      mask_level[pv] = masks[pv].test(level);
+      transposed[level][pv] = masks[pv].test(level);
     }
-    retval.push_back(mask_level);
   }
+}
 
-  return retval;
+//
+// Network signature.
+//
+
+static inline void HashCombine(std::uint64_t& seed, std::uint64_t value)
+{
+  // splitmix64 finalizer over the running hash.
+  seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+  seed ^= seed >> 30;
+  seed *= 0xbf58476d1ce4e5b9ULL;
+  seed ^= seed >> 27;
+  seed *= 0x94d049bb133111ebULL;
+  seed ^= seed >> 31;
+}
+
+static inline void HashCombine(std::uint64_t& seed, double value)
+{
+  std::uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  HashCombine(seed, bits);
+}
+
+template <typename T>
+static void HashHistogram(std::uint64_t& seed, const MulticastHistogram<T>& histogram)
+{
+  HashCombine(seed, std::uint64_t(histogram.size()));
+  for (auto& entry : histogram)
+  {
+    HashCombine(seed, entry.first);
+    HashCombine(seed, entry.second);
+  }
+}
+
+std::uint64_t NetworkSignature(const CompoundTile& tile)
+{
+  std::uint64_t seed = 0;
+  for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
+  {
+    auto& info = tile[pv];
+    HashHistogram(seed, info.accesses);
+    HashHistogram(seed, info.scatter_factors);
+    HashHistogram(seed, info.cumulative_hops);
+    HashCombine(seed, std::uint64_t(info.size));
+    HashCombine(seed, std::uint64_t(info.partition_size));
+    HashCombine(seed, std::uint64_t(info.distributed_multicast));
+    HashCombine(seed, info.link_transfers);
+    HashCombine(seed, info.replication_factor);
+    HashCombine(seed, info.fanout);
+    HashCombine(seed, info.distributed_fanout);
+  }
+  return seed;
+}
+
+void NetworkFields::Assign(const TileInfo& tile)
+{
+  size = tile.size;
+  partition_size = tile.partition_size;
+  distributed_multicast = tile.distributed_multicast;
+  accesses = tile.accesses;
+  scatter_factors = tile.scatter_factors;
+  cumulative_hops = tile.cumulative_hops;
+  link_transfers = tile.link_transfers;
+  replication_factor = tile.replication_factor;
+  fanout = tile.fanout;
+  distributed_fanout = tile.distributed_fanout;
+}
+
+bool NetworkFields::Matches(const TileInfo& tile) const
+{
+  return size == tile.size &&
+    partition_size == tile.partition_size &&
+    distributed_multicast == tile.distributed_multicast &&
+    link_transfers == tile.link_transfers &&
+    replication_factor == tile.replication_factor &&
+    fanout == tile.fanout &&
+    distributed_fanout == tile.distributed_fanout &&
+    accesses == tile.accesses &&
+    scatter_factors == tile.scatter_factors &&
+    cumulative_hops == tile.cumulative_hops;
+}
+
+void AssignNetworkFields(CompoundNetworkFields& fields, const CompoundTile& tile)
+{
+  for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
+  {
+    fields[pv].Assign(tile[pv]);
+  }
+}
+
+bool MatchesNetworkFields(const CompoundNetworkFields& fields, const CompoundTile& tile)
+{
+  for (unsigned pv = 0; pv < problem::GetShape()->NumDataSpaces; pv++)
+  {
+    if (!fields[pv].Matches(tile[pv]))
+    {
+      return false;
+    }
+  }
+  return true;
 }
 
 }  // namespace tiling
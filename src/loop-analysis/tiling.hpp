@@ -30,6 +30,7 @@
 #include <bitset>
 
 #include "mapping/loop.hpp"
+#include "loop-analysis/multicast-histogram.hpp"
 #include "util/numeric.hpp"
 #include "workload/problem-shape.hpp"
 #include "workload/per-data-space.hpp"
@@ -58,9 +59,9 @@ struct TileInfo
   std::size_t size;
   std::size_t partition_size;
   bool distributed_multicast;
-  std::vector<std::uint64_t> accesses;   // accesses at various multicast factors.
-  std::vector<std::uint64_t> scatter_factors;
-  std::vector<double> cumulative_hops;
+  MulticastHistogram<std::uint64_t> accesses;   // accesses at various multicast factors.
+  MulticastHistogram<std::uint64_t> scatter_factors;
+  MulticastHistogram<double> cumulative_hops;
   std::uint64_t content_accesses;
   std::uint64_t fills;
   std::uint64_t link_transfers;
@@ -77,26 +78,34 @@ struct TileInfo
 
   std::uint64_t GetTotalAccesses() const
   {
-    return std::accumulate(accesses.begin(), accesses.end(), static_cast<std::uint64_t>(0));
+    return accesses.Total();
   }
   
   std::uint64_t GetWeightedAccesses() const
   {
     std::uint64_t total = 0;
-    for (std::uint32_t i = 0; i < accesses.size(); i++)
+    for (auto& entry : accesses)
     {
-      total += accesses[i] * (i + 1);
+      total += entry.second * entry.first;
     }
     return total;
   }
 
+  // Number of multicast factors spanned by this tile's network statistics:
+  // the fanout, unless distributed multicast pushed accesses beyond it. A
+  // tile without accesses still spans its fanout (none once reset).
+  std::uint64_t GetMulticastRange() const
+  {
+    return accesses.empty() ? fanout : std::max(fanout, accesses.MaxFactor());
+  }
+
   void Reset()
   {
     size = 0;
     partition_size = 0;
-    accesses.resize(0);
-    scatter_factors.resize(0);
-    cumulative_hops.resize(0);
+    accesses.clear();
+    scatter_factors.clear();
+    cumulative_hops.clear();
     content_accesses = 0;
     fills = 0;
     link_transfers = 0;
@@ -111,12 +120,12 @@ struct TileInfo
   void Validate()
   {
     std::uint64_t f = 0;
-    for (std::uint64_t i = 0; i < fanout; i++)
+    for (auto& entry : accesses)
     {
-      if (accesses[i] != 0)
+      if (entry.first <= fanout && entry.second != 0)
       {
-        auto multicast_factor = i + 1;
-        auto scatter_factor = scatter_factors[i];
+        auto multicast_factor = entry.first;
+        auto scatter_factor = scatter_factors.Get(multicast_factor);
         f += (multicast_factor * scatter_factor);
       }
     }
@@ -125,12 +134,12 @@ struct TileInfo
     {
       std::cerr << "ERROR: sigma(multicast * scatter) != fanout." << std::endl;
       std::cerr << "  dumping (multicast, scatter) pairs:" << std::endl;
-      for (std::uint64_t i = 0; i < fanout; i++)
+      for (auto& entry : accesses)
       {
-        if (accesses[i] != 0)
+        if (entry.first <= fanout && entry.second != 0)
         {
-          auto multicast_factor = i + 1;
-          auto scatter_factor = scatter_factors[i];
+          auto multicast_factor = entry.first;
+          auto scatter_factor = scatter_factors.Get(multicast_factor);
           std::cerr << "    " << multicast_factor << ", " << scatter_factor << std::endl;
         }
       }
@@ -164,14 +173,58 @@ typedef problem::PerDataSpace<std::bitset<MaxTilingLevels>> CompoundMaskNest;
 typedef std::vector<CompoundTile> NestOfCompoundTiles;
 typedef std::vector<CompoundMask> NestOfCompoundMasks;
 
+// Buffers for the tile post-processing pipeline. The pipeline overwrites
+// them in place, so an owner that evaluates many mappings (e.g., an Engine
+// in a mapper thread) stops allocating once they have grown to the size of
+// its largest nest.
+struct TilePipelineBuffers
+{
+  CompoundTileNest collapsed;  // per-data-space scratch nests.
+  NestOfCompoundTiles tiles;   // result, in level->data-space order.
+  NestOfCompoundMasks masks;   // keep masks, in level->data-space order.
+};
+
 bool operator < (const TileInfo& a, const TileInfo& b);
 std::ostream& operator << (std::ostream& out, const TileInfo& info);
 
-//nCompoundTileNest CollapseTiles(CompoundTileNest& tiles, int num_tiling_levels);
-CompoundTileNest CollapseTiles(CompoundTileNest& tiles, int num_tiling_levels,
-                               const CompoundMaskNest& tile_mask,
-                               const CompoundMaskNest& distribution_supported);
-NestOfCompoundTiles TransposeTiles(const CompoundTileNest& tiles);
+// Collapses the working-set tiles into num_tiling_levels storage levels, runs
+// the post-processing passes (partition sizes, fills, masking, distributed
+// multicast, peer accesses) and leaves the result transposed into
+// buffers.tiles.
+void CollapseTiles(const CompoundTileNest& tiles, int num_tiling_levels,
+                   const CompoundMaskNest& tile_mask,
+                   const CompoundMaskNest& distribution_supported,
+                   TilePipelineBuffers& buffers);
 NestOfCompoundMasks TransposeMasks(const CompoundMaskNest& masks);
+void TransposeMasks(const CompoundMaskNest& masks, NestOfCompoundMasks& transposed);
+
+// 64-bit hash of the tile fields that network models read (multicast,
+// scatter and hop histograms, fanouts, replication, sizes, link transfers).
+// Networks memoize their stats on it across mappings.
+std::uint64_t NetworkSignature(const CompoundTile& tile);
+
+// A copy of the fields that NetworkSignature() hashes, kept by network stats
+// memos to confirm that a signature match really is the same tile.
+struct NetworkFields
+{
+  std::size_t size = 0;
+  std::size_t partition_size = 0;
+  bool distributed_multicast = false;
+  MulticastHistogram<std::uint64_t> accesses;
+  MulticastHistogram<std::uint64_t> scatter_factors;
+  MulticastHistogram<double> cumulative_hops;
+  std::uint64_t link_transfers = 0;
+  std::uint64_t replication_factor = 0;
+  std::uint64_t fanout = 0;
+  std::uint64_t distributed_fanout = 0;
+
+  void Assign(const TileInfo& tile);
+  bool Matches(const TileInfo& tile) const;
+};
+
+typedef problem::PerDataSpace<NetworkFields> CompoundNetworkFields;
+
+void AssignNetworkFields(CompoundNetworkFields& fields, const CompoundTile& tile);
+bool MatchesNetworkFields(const CompoundNetworkFields& fields, const CompoundTile& tile);
 
 }  // namespace tiling
@@ -119,6 +119,15 @@ class ArchProperties
   {
     specs_ = arch_specs;
 
+    // Reset derived state in case we are being re-constructed.
+    spatial_mask_.clear();
+    twoD_spatial_mask_.clear();
+    temporal_to_tiling_map_.clear();
+    spatial_to_tiling_map_.clear();
+    tiling_to_storage_map_.clear();
+    fanoutX_map_.clear();
+    fanoutY_map_.clear();
+
     // Derive fanouts.
     DeriveFanouts();
     
@@ -26,6 +26,7 @@
  */
 
 #include <regex>
+#include <sstream>
 
 #include "parser.hpp"
 #include "arch-properties.hpp"
@@ -74,7 +75,10 @@ Mapping ParseAndConstruct(config::CompoundConfigNode config,
   }
 
   // Parse user-provided mapping.
-  assert(config.isList());
+  if (!config.isList())
+  {
+    throw ParseError("parsing mapping: mapping must be a list of directives");
+  }
   
   // Iterate over all the directives.
   int len = config.getLength();
@@ -83,7 +87,10 @@ Mapping ParseAndConstruct(config::CompoundConfigNode config,
     auto directive = config[i];
     // Find out if this is a temporal directive or a spatial directive.
     std::string type;
-    assert(directive.lookupValue("type", type));
+    if (!directive.lookupValue("type", type))
+    {
+      throw ParseError("parsing mapping: directive without a type");
+    }
 
     auto level_id = FindTargetTilingLevel(directive, type);
 
@@ -115,10 +122,6 @@ Mapping ParseAndConstruct(config::CompoundConfigNode config,
                                       arch_props_.TilingToStorage(level_id),
                                       user_bypass_strings);
     }
-    else
-    {
-      assert(false);
-    }
   }
 
   // Validity checks.
@@ -137,29 +140,25 @@ Mapping ParseAndConstruct(config::CompoundConfigNode config,
     auto permutation = user_permutations.find(level);
     if (permutation == user_permutations.end())
     {
-      std::cerr << "ERROR: parsing mapping: permutation not found for level: "
-                << arch_props_.TilingLevelName(level) << std::endl;
-      exit(1);
+      throw ParseError("parsing mapping: permutation not found for level: " +
+                       arch_props_.TilingLevelName(level));
     }
     if (permutation->second.size() != std::size_t(problem::GetShape()->NumDimensions))
     {
-      std::cerr << "ERROR: parsing mapping: permutation contains insufficient dimensions at level: "
-                << arch_props_.TilingLevelName(level) << std::endl;
-      exit(1);
+      throw ParseError("parsing mapping: permutation contains insufficient dimensions at level: " +
+                       arch_props_.TilingLevelName(level));
     }
       
     auto factors = user_factors.find(level);
     if (factors == user_factors.end())
     {
-      std::cerr << "ERROR: parsing mapping: factors not found for level: "
-                << arch_props_.TilingLevelName(level) << std::endl;
-      exit(1);
+      throw ParseError("parsing mapping: factors not found for level: " +
+                       arch_props_.TilingLevelName(level));
     }
     if (factors->second.size() != std::size_t(problem::GetShape()->NumDimensions))
     {
-      std::cerr << "ERROR: parsing mapping: factors not provided for all dimensions at level: "
-                << arch_props_.TilingLevelName(level) << std::endl;
-      exit(1);
+      throw ParseError("parsing mapping: factors not provided for all dimensions at level: " +
+                       arch_props_.TilingLevelName(level));
     }
 
     // Each partition has problem::GetShape()->NumDimensions loops.
@@ -180,22 +179,21 @@ Mapping ParseAndConstruct(config::CompoundConfigNode config,
   }
 
   // All user-provided factors must multiply-up to the dimension size.
-  bool fault = false;
+  std::ostringstream fault;
   for (unsigned dim = 0; dim < problem::GetShape()->NumDimensions; dim++)
   {
     if (dimension_factor_products[dim] != workload_.GetBound(dim))
     {
-      std::cerr << "ERROR: parsing mapping: product of all factors of dimension "
-                << problem::GetShape()->DimensionIDToName.at(dim) << " is "
-                << dimension_factor_products[dim] << ", which is not equal to "
-                << "the dimension size of the workload " << workload_.GetBound(dim)
-                << "." << std::endl;
-      fault = true;
+      fault << (fault.tellp() > 0 ? "; " : "parsing mapping: ")
+            << "product of all factors of dimension "
+            << problem::GetShape()->DimensionIDToName.at(dim) << " is "
+            << dimension_factor_products[dim] << ", which is not equal to "
+            << "the dimension size of the workload " << workload_.GetBound(dim);
     }
   }
-  if (fault)
+  if (fault.tellp() > 0)
   {
-    exit(1);
+    throw ParseError(fault.str());
   }
 
   // Concatenate the subnests to form the final mapping nest.
@@ -237,7 +235,12 @@ Mapping ParseAndConstruct(config::CompoundConfigNode config,
     auto pv = problem::Shape::DataSpaceID(pvi);
 
     // Start parsing the user mask string.
-    assert(user_bypass_strings.at(pv).length() <= arch_props_.StorageLevels());
+    if (user_bypass_strings.at(pv).length() > arch_props_.StorageLevels())
+    {
+      throw ParseError("parsing mapping: bypass string for " +
+                       problem::GetShape()->DataSpaceIDToName.at(pv) +
+                       " is longer than the storage hierarchy");
+    }
 
     // The first loop runs the length of the user-specified string.
     unsigned level = 0;
@@ -260,8 +263,8 @@ Mapping ParseAndConstruct(config::CompoundConfigNode config,
           break;          
             
         default:
-          assert(false);
-          break;
+          throw ParseError(std::string("parsing mapping: invalid bypass setting '") +
+                           spec + "' for " + problem::GetShape()->DataSpaceIDToName.at(pv));
       }
     }
   } // for (pvi)
@@ -295,20 +298,19 @@ unsigned FindTargetTilingLevel(config::CompoundConfigNode directive, std::string
     }
     if (storage_level_id == num_storage_levels)
     {
-      std::cerr << "ERROR: target storage level not found: " << storage_level_name << std::endl;
-      exit(1);
+      throw ParseError("parsing mapping: target storage level not found: " + storage_level_name);
     }
   }
   else
   {
     int id;
-    assert(directive.lookupValue("target", id));
-    assert(id >= 0  && id < int(num_storage_levels));
+    if (!directive.lookupValue("target", id) || id < 0 || id >= int(num_storage_levels))
+    {
+      throw ParseError("parsing mapping: " + type + " directive without a valid target");
+    }
     storage_level_id = static_cast<unsigned>(id);
   }
 
-  assert(storage_level_id < num_storage_levels);
-
   //
   // Translate this storage ID to a tiling ID.
   //
@@ -327,23 +329,23 @@ unsigned FindTargetTilingLevel(config::CompoundConfigNode directive, std::string
     }
     catch (const std::out_of_range& oor)
     {
-      std::cerr << "ERROR: cannot find spatial tiling level associated with "
-                << "storage level " << arch_props_.StorageLevelName(storage_level_id)
-                << ". This is because the number of instances of the next-inner "
-                << "level ";
+      std::ostringstream msg;
+      msg << "parsing mapping: cannot find spatial tiling level associated with "
+          << "storage level " << arch_props_.StorageLevelName(storage_level_id)
+          << ". This is because the number of instances of the next-inner "
+          << "level ";
       if (storage_level_id != 0)
       {
-        std::cerr << "(" << arch_props_.StorageLevelName(storage_level_id-1) << ") ";
+        msg << "(" << arch_props_.StorageLevelName(storage_level_id-1) << ") ";
       }
-      std::cerr << "is the same as this level, which means there cannot "
-                << "be a spatial fanout." << std::endl;
-      exit(1);
+      msg << "is the same as this level, which means there cannot "
+          << "be a spatial fanout.";
+      throw ParseError(msg.str());
     }
   }
   else
   {
-    std::cerr << "ERROR: unrecognized mapping directive type: " << type << std::endl;
-    exit(1);
+    throw ParseError("parsing mapping: unrecognized mapping directive type: " + type);
   }
 
   return tiling_level_id;
@@ -373,9 +375,8 @@ std::map<problem::Shape::DimensionID, int> ParseUserFactors(config::CompoundConf
       }
       catch (const std::out_of_range& oor)
       {
-        std::cerr << "ERROR: parsing factors: " << buffer << ": dimension " << dimension_name
-                  << " not found in problem shape." << std::endl;
-        exit(1);
+        throw ParseError("parsing factors: " + buffer + ": dimension " + dimension_name +
+                         " not found in problem shape.");
       }
 
       int end = std::stoi(sm[2]);
@@ -421,8 +422,13 @@ std::vector<problem::Shape::DimensionID> ParseUserPermutations(config::CompoundC
     char token;
     while (iss >> token)
     {
-      auto dimension = problem::GetShape()->DimensionNameToID.at(std::string(1, token)); // note: can fault.
-      retval.push_back(dimension);
+      auto it = problem::GetShape()->DimensionNameToID.find(std::string(1, token));
+      if (it == problem::GetShape()->DimensionNameToID.end())
+      {
+        throw ParseError("parsing permutation: " + buffer + ": dimension " + std::string(1, token) +
+                         " not found in problem shape.");
+      }
+      retval.push_back(it->second);
     }
   }
 
@@ -27,6 +27,8 @@
 
 #pragma once
 
+#include <stdexcept>
+
 #include "mapping.hpp"
 #include "model/engine.hpp"
 #include "compound-config/compound-config.hpp"
@@ -34,6 +36,15 @@
 namespace mapping
 {
 
+// Thrown by ParseAndConstruct() on a malformed mapping. Long-running hosts
+// (the server, the C API) reject the offending request; the command-line
+// tools report it and exit.
+class ParseError : public std::runtime_error
+{
+ public:
+  using std::runtime_error::runtime_error;
+};
+
 Mapping ParseAndConstruct(config::CompoundConfigNode config, model::Engine::Specs& arch_specs, problem::Workload workload);
 
 } // namespace mapping
@@ -67,12 +67,17 @@ class MapSpace
   const problem::Workload& workload_;
   std::array<uint128_t, int(Dimension::Num)> size_;
 
+  // Whether InitPruned() may also drop permutations that only construct
+  // mappings with the same reuse as another one (see skip-duplicates).
+  bool prune_duplicates_;
+
  public:
   MapSpace(model::Engine::Specs arch_specs,
            const problem::Workload& workload) :
       arch_specs_(arch_specs),
       workload_(workload),
-      size_({})
+      size_({}),
+      prune_duplicates_(true)
   {}
 
   virtual ~MapSpace() {}
@@ -81,6 +86,12 @@ class MapSpace
 
   virtual void InitPruned(uint128_t local_index_factorization_id) = 0;
 
+  // Must be set before Split(), which copies it into the splits.
+  void SetPruneDuplicates(bool prune_duplicates)
+  {
+    prune_duplicates_ = prune_duplicates;
+  }
+
   virtual bool ConstructMapping(ID mapping_id, Mapping* mapping) = 0;
 
   bool ConstructMapping(const uint128_t mapping_id,
@@ -91,6 +102,29 @@ class MapSpace
     return ConstructMapping(cmapping_id, mapping); 
   }
 
+  // Map an ID to the canonical representative of the set of IDs that
+  // construct the same mapping. Mapspaces that cannot tell return the ID.
+  virtual ID Canonicalize(ID mapping_id)
+  {
+    return mapping_id;
+  }
+
+  // How an ID relates to its canonical representative. A Duplicate stays
+  // non-canonical under every datatype bypass choice; a BypassDuplicate may
+  // only be non-canonical under its own.
+  enum class Canonicality
+  {
+    Canonical,
+    BypassDuplicate,
+    Duplicate
+  };
+
+  virtual Canonicality CheckCanonical(ID mapping_id)
+  {
+    return Canonicalize(mapping_id).Integer() == mapping_id.Integer() ?
+      Canonicality::Canonical : Canonicality::BypassDuplicate;
+  }
+
   uint128_t Size(Dimension dim)
   {
     return size_[int(dim)];
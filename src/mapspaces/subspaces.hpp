@@ -143,7 +143,8 @@ class PermutationSpace
   }
 
   void InitLevel(uint64_t level, std::vector<problem::Shape::DimensionID> user_prefix,
-                 std::vector<problem::Shape::DimensionID> pruned_dimensions = {})
+                 std::vector<problem::Shape::DimensionID> pruned_dimensions = {},
+                 bool collapse_suffix = false)
   {
     assert(level < num_levels_);
 
@@ -169,6 +170,14 @@ class PermutationSpace
     for (auto& dim : unspecified_dimensions)
       permutable_suffix.push_back(dim);
 
+    // If every order of the free dimensions is known to be equivalent, bake
+    // them in (in dimension order) instead of exposing a permutation space.
+    if (collapse_suffix)
+    {
+      baked_prefix.insert(baked_prefix.end(), permutable_suffix.begin(), permutable_suffix.end());
+      permutable_suffix.clear();
+    }
+
     assert(baked_prefix.size() + permutable_suffix.size() == unsigned(problem::GetShape()->NumDimensions));
 
     patterns_[level] = { baked_prefix, permutable_suffix };
@@ -202,6 +211,34 @@ class PermutationSpace
     return retval;
   }
 
+  // Inverse of GetPatterns(). Each level's pattern must keep that level's
+  // baked prefix.
+  uint128_t GetID(const std::vector<std::vector<problem::Shape::DimensionID>>& patterns)
+  {
+    uint128_t id = 0;
+    uint128_t scale = 1;
+
+    for (unsigned level = 0; level < num_levels_; level++)
+    {
+      auto& pattern = patterns_.at(level);
+      if (pattern.baked_prefix.size() != unsigned(problem::GetShape()->NumDimensions))
+      {
+        auto& permuted_suffix = patterns.at(level);
+        id += scale * factoradic_.Index(pattern.permutable_suffix.data(),
+                                        permuted_suffix.data() + pattern.baked_prefix.size(),
+                                        pattern.permutable_suffix.size());
+        scale *= size_.at(level);
+      }
+    }
+
+    return id;
+  }
+
+  std::size_t PrefixLength(uint64_t level) const
+  {
+    return patterns_.at(level).baked_prefix.size();
+  }
+
   uint128_t Size() const
   {
     uint128_t product = 1;
@@ -290,6 +327,36 @@ class SpatialSplitSpace
     return retval;
   }
 
+  // Inverse of GetSplits().
+  uint128_t GetID(const std::map<unsigned, std::uint32_t>& splits)
+  {
+    uint128_t id = 0;
+    uint128_t scale = 1;
+
+    for (unsigned level = 0; level < num_levels_; level++)
+    {
+      auto it_is_user_specified = is_user_specified_.find(level);
+      if (it_is_user_specified != is_user_specified_.end() && !it_is_user_specified->second)
+      {
+        id += scale * (splits.at(level) - unit_factors_.at(level));
+        scale *= size_.at(level);
+      }
+    }
+
+    return id;
+  }
+
+  bool IsUserSpecified(uint64_t level) const
+  {
+    return is_user_specified_.at(level);
+  }
+
+  // Smallest split point that the space generates at a variable level.
+  std::uint32_t MinSplit(uint64_t level) const
+  {
+    return unit_factors_.at(level);
+  }
+
   uint128_t Size() const
   {
     uint128_t retval = 1;
@@ -30,6 +30,7 @@
 #include <iterator>
 #include <mutex>
 #include <regex>
+#include <set>
 
 #include "util/numeric.hpp"
 #include "util/misc.hpp"
@@ -68,6 +69,23 @@ class Uber : public MapSpace
   // Constraints.
   mapping::Constraints constraints_;
 
+  // How each problem dimension indexes each dataspace: not at all, alone in
+  // a dataspace dimension, or together with other problem dimensions (e.g.,
+  // a sliding window). Used to find loop orders with identical reuse.
+  enum class Indexing
+  {
+    None,
+    Simple,
+    Compound
+  };
+  std::vector<std::vector<Indexing>> dimension_indexing_;
+
+  // Unit-factor flags (per level, per dimension) of the last index
+  // factorization seen by Canonicalize(). Searches visit many IDs in a row
+  // with the same index factorization.
+  uint128_t unit_factors_if_id_;
+  std::vector<std::vector<bool>> unit_factors_;
+
  public:
 
   //
@@ -85,7 +103,8 @@ class Uber : public MapSpace
       split_id_(0),
       num_parent_splits_(0),
       arch_props_(arch_specs),
-      constraints_(arch_props_, workload)
+      constraints_(arch_props_, workload),
+      unit_factors_if_id_(0)
   {
     if (!skip_init)
     {
@@ -106,6 +125,7 @@ class Uber : public MapSpace
     Parse(config, arch_constraints);
 
     // Setup all the mapping sub-spaces.
+    InitDimensionIndexing();
     InitIndexFactorizationSpace();
     InitLoopPermutationSpace();
     InitSpatialSpace();
@@ -137,6 +157,32 @@ class Uber : public MapSpace
     }
   }
   
+  //
+  // InitDimensionIndexing()
+  //
+  void InitDimensionIndexing()
+  {
+    auto shape = problem::GetShape();
+
+    dimension_indexing_.assign(shape->NumDataSpaces,
+                               std::vector<Indexing>(shape->NumDimensions, Indexing::None));
+
+    for (unsigned pvi = 0; pvi < shape->NumDataSpaces; pvi++)
+    {
+      for (auto& expression : shape->Projections.at(pvi))
+      {
+        for (auto& term : expression)
+        {
+          auto& indexing = dimension_indexing_.at(pvi).at(term.second);
+          if (indexing == Indexing::None && expression.size() == 1)
+            indexing = Indexing::Simple;
+          else
+            indexing = Indexing::Compound;
+        }
+      }
+    }
+  }
+
   //
   // InitIndexFactorizationSpace()
   //
@@ -217,7 +263,8 @@ class Uber : public MapSpace
   //
   // InitLoopPermutationSpace()
   //
-  void InitLoopPermutationSpace(std::map<unsigned, std::vector<problem::Shape::DimensionID>> pruned_dimensions = {})
+  void InitLoopPermutationSpace(std::map<unsigned, std::vector<problem::Shape::DimensionID>> pruned_dimensions = {},
+                                std::set<unsigned> collapsed_levels = {})
   {
     auto user_permutations = constraints_.Permutations();
 
@@ -254,11 +301,12 @@ class Uber : public MapSpace
         // user-provided pattern. If this pattern is empty or incomplete,
         // it exposes a permutation space. This logic is handled by the
         // permutation space object itself.
+        bool collapse = (collapsed_levels.find(level) != collapsed_levels.end());
         auto it = pruned_dimensions.find(level);
         if (it != pruned_dimensions.end())
-          permutation_space_.InitLevel(level, user_prefix, it->second);
+          permutation_space_.InitLevel(level, user_prefix, it->second, collapse);
         else
-          permutation_space_.InitLevel(level, user_prefix);
+          permutation_space_.InitLevel(level, user_prefix, {}, collapse);
       }
     }    
 
@@ -509,8 +557,51 @@ class Uber : public MapSpace
       unit_factors[level] = pruned_dimensions[level].size();
     }
 
+    // Find temporal levels at which every order of the free (non-unit,
+    // non-user-specified) loops has the same reuse under every bypass
+    // choice. These levels need only one permutation.
+    std::set<unsigned> collapsed_levels;
+    for (uint64_t level = 0; prune_duplicates_ && level < arch_props_.TilingLevels(); level++)
+    {
+      if (arch_props_.IsSpatial(level))
+        continue;
+
+      std::vector<bool> inner_kept(problem::GetShape()->NumDataSpaces, false);
+      for (auto& mask_nest : datatype_bypass_nest_space_)
+      {
+        auto kept = InnerKeptDataSpaces(mask_nest, level);
+        for (unsigned pvi = 0; pvi < kept.size(); pvi++)
+          inner_kept[pvi] = inner_kept[pvi] || kept[pvi];
+      }
+
+      std::vector<problem::Shape::DimensionID> free_dimensions;
+      auto it = user_permutations.find(level);
+      for (unsigned idim = 0; idim < unsigned(problem::GetShape()->NumDimensions); idim++)
+      {
+        auto dim = problem::Shape::DimensionID(idim);
+        bool user_specified = (it != user_permutations.end() &&
+                               std::find(it->second.begin(), it->second.end(), dim) != it->second.end());
+        if (!user_specified &&
+            index_factorization_space_.GetFactor(mapping_index_factorization_id, dim, level) != 1)
+        {
+          free_dimensions.push_back(dim);
+        }
+      }
+
+      bool collapse = true;
+      for (unsigned i = 0; i < free_dimensions.size() && collapse; i++)
+      {
+        for (unsigned j = i + 1; j < free_dimensions.size() && collapse; j++)
+        {
+          collapse = LoopsCommute(free_dimensions[i], free_dimensions[j], inner_kept);
+        }
+      }
+      if (collapse)
+        collapsed_levels.insert(level);
+    }
+
     // Re-initialize the Permutation and Spatial Split sub-spaces.
-    InitLoopPermutationSpace(pruned_dimensions);
+    InitLoopPermutationSpace(pruned_dimensions, collapsed_levels);
     InitSpatialSpace(unit_factors);
   }
 
@@ -848,6 +939,236 @@ class Uber : public MapSpace
     return datatype_bypass_nest_space_.at(int(mapping_datatype_bypass_id));
   }
 
+  //------------------------------------------//
+  //             Canonicalization             // 
+  //------------------------------------------//
+
+  //
+  // Canonicalize()
+  //   ConstructMapping() drops unit-factor loops, so their positions in a
+  //   level's permutation and their side of a spatial X/Y split do not
+  //   matter. Map an ID to a canonical representative without constructing
+  //   the mapping: in the permutable suffix of each level, unit-factor
+  //   dimensions are gathered (in dimension order) at the front of each X/Y
+  //   segment, and a variable spatial split is moved to the smallest split
+  //   point that keeps the same non-unit loops along X. At temporal levels,
+  //   each run of adjacent loops that commute under the ID's bypass choice
+  //   (see LoopsCommute()) is sorted in dimension order.
+  //
+  mapspace::ID Canonicalize(mapspace::ID mapping_id)
+  {
+    std::vector<std::vector<problem::Shape::DimensionID>> patterns;
+    std::map<unsigned, std::uint32_t> spatial_splits;
+    bool bypass_independent;
+
+    if (CanonicalizeSubspaces(mapping_id, patterns, spatial_splits, bypass_independent))
+    {
+      mapping_id.Set(int(mapspace::Dimension::LoopPermutation), permutation_space_.GetID(patterns));
+      mapping_id.Set(int(mapspace::Dimension::Spatial), spatial_split_space_.GetID(spatial_splits));
+    }
+
+    return mapping_id;
+  }
+
+  // Cheaper than comparing against Canonicalize(): the canonical ID is
+  // never re-encoded.
+  Canonicality CheckCanonical(mapspace::ID mapping_id)
+  {
+    std::vector<std::vector<problem::Shape::DimensionID>> patterns;
+    std::map<unsigned, std::uint32_t> spatial_splits;
+    bool bypass_independent;
+
+    if (!CanonicalizeSubspaces(mapping_id, patterns, spatial_splits, bypass_independent))
+      return Canonicality::Canonical;
+    return bypass_independent ? Canonicality::Duplicate : Canonicality::BypassDuplicate;
+  }
+
+  // Decode the permutations and spatial splits of an ID into their canonical
+  // form. Returns true if either of them changed. bypass_independent is set
+  // if a change does not depend on the ID's bypass choice (unit-factor
+  // gathering or a split move), so that every bypass choice of the same
+  // IF, LP and S is non-canonical too.
+  bool CanonicalizeSubspaces(mapspace::ID& mapping_id,
+                             std::vector<std::vector<problem::Shape::DimensionID>>& patterns,
+                             std::map<unsigned, std::uint32_t>& spatial_splits,
+                             bool& bypass_independent)
+  {
+    assert(!IsSplit());
+
+    unsigned num_dims = unsigned(problem::GetShape()->NumDimensions);
+    bool changed = false;
+    bypass_independent = false;
+
+    uint128_t mapping_index_factorization_id =
+      mapping_id[int(mapspace::Dimension::IndexFactorization)] * num_parent_splits_ + split_id_;
+
+    patterns = permutation_space_.GetPatterns(mapping_id[int(mapspace::Dimension::LoopPermutation)]);
+    spatial_splits = spatial_split_space_.GetSplits(mapping_id[int(mapspace::Dimension::Spatial)]);
+    auto& mask_nest = datatype_bypass_nest_space_.at(int(mapping_id[int(mapspace::Dimension::DatatypeBypass)]));
+
+    for (uint64_t level = 0; level < arch_props_.TilingLevels(); level++)
+    {
+      auto& pattern = patterns.at(level);
+      unsigned suffix_start = permutation_space_.PrefixLength(level);
+      auto& is_unit = UnitFactors(mapping_index_factorization_id).at(level);
+
+      bool is_spatial = arch_props_.IsSpatial(level);
+      bool variable_split = is_spatial && !spatial_split_space_.IsUserSpecified(level);
+
+      // A variable split only needs to preserve the set of loops along X.
+      std::vector<bool> along_x(num_dims, false);
+      if (variable_split)
+      {
+        for (unsigned i = 0; i < spatial_splits.at(level); i++)
+          along_x[int(pattern[i])] = true;
+      }
+
+      // A user-specified split is fixed, so unit dimensions may only move
+      // within each side of it.
+      std::vector<unsigned> segment_bounds = { suffix_start };
+      if (is_spatial && !variable_split)
+      {
+        unsigned split = spatial_splits.at(level);
+        if (split > suffix_start && split < num_dims)
+          segment_bounds.push_back(split);
+      }
+      segment_bounds.push_back(num_dims);
+
+      std::vector<problem::Shape::DimensionID> units;
+      for (unsigned i = suffix_start; i < num_dims; i++)
+      {
+        if (is_unit[int(pattern[i])])
+          units.push_back(pattern[i]);
+      }
+      std::sort(units.begin(), units.end());
+
+      std::vector<problem::Shape::DimensionID> canonical(pattern.begin(), pattern.begin() + suffix_start);
+      auto next_unit = units.begin();
+      for (unsigned segment = 0; segment + 1 < segment_bounds.size(); segment++)
+      {
+        auto begin = pattern.begin() + segment_bounds[segment];
+        auto end = pattern.begin() + segment_bounds[segment + 1];
+        for (auto it = begin; it != end; it++)
+        {
+          if (is_unit[int(*it)])
+            canonical.push_back(*next_unit++);
+        }
+        for (auto it = begin; it != end; it++)
+        {
+          if (!is_unit[int(*it)])
+            canonical.push_back(*it);
+        }
+      }
+      // Commuting runs are only sorted past the gathered unit-factor loops,
+      // so a unit misplaced here is misplaced under every bypass choice.
+      if (canonical != pattern)
+        bypass_independent = true;
+
+      if (!is_spatial)
+      {
+        // Unit-factor loops are dropped from the nest, so they do not
+        // break up a run.
+        auto inner_kept = InnerKeptDataSpaces(mask_nest, level);
+        auto run_begin = canonical.begin() + suffix_start + units.size();
+        for (auto it = run_begin; it != canonical.end(); it++)
+        {
+          if (it + 1 == canonical.end() || !LoopsCommute(*it, *(it + 1), inner_kept))
+          {
+            std::sort(run_begin, it + 1);
+            run_begin = it + 1;
+          }
+        }
+      }
+
+      if (canonical != pattern)
+      {
+        pattern = canonical;
+        changed = true;
+      }
+
+      if (variable_split)
+      {
+        std::uint32_t split = spatial_split_space_.MinSplit(level);
+        for (unsigned i = 0; i < num_dims; i++)
+        {
+          if (!is_unit[int(pattern[i])] && along_x[int(pattern[i])])
+            split = std::max(split, std::uint32_t(i + 1));
+        }
+        if (split != spatial_splits.at(level))
+        {
+          spatial_splits[level] = split;
+          changed = true;
+          bypass_independent = true;
+        }
+      }
+    }
+
+    return changed;
+  }
+
+  const std::vector<std::vector<bool>>& UnitFactors(uint128_t mapping_index_factorization_id)
+  {
+    if (unit_factors_.empty() || unit_factors_if_id_ != mapping_index_factorization_id)
+    {
+      unit_factors_.assign(arch_props_.TilingLevels(),
+                           std::vector<bool>(problem::GetShape()->NumDimensions));
+      for (uint64_t level = 0; level < arch_props_.TilingLevels(); level++)
+      {
+        for (unsigned idim = 0; idim < unsigned(problem::GetShape()->NumDimensions); idim++)
+        {
+          unit_factors_[level][idim] = (index_factorization_space_.GetFactor(
+                                          mapping_index_factorization_id, problem::Shape::DimensionID(idim), level) == 1);
+        }
+      }
+      unit_factors_if_id_ = mapping_index_factorization_id;
+    }
+    return unit_factors_;
+  }
+
+  //
+  // InnerKeptDataSpaces()
+  //   Dataspaces kept at some storage level inside a tiling level. The loop
+  //   order at a level only affects the reuse of these dataspaces; the
+  //   others are read by the arithmetic units on every operation.
+  //
+  std::vector<bool> InnerKeptDataSpaces(const tiling::CompoundMaskNest& mask_nest, uint64_t level)
+  {
+    std::vector<bool> kept(problem::GetShape()->NumDataSpaces, false);
+    unsigned storage_level = arch_props_.TilingToStorage(level);
+    for (unsigned pvi = 0; pvi < kept.size(); pvi++)
+    {
+      for (unsigned inner = 0; inner < storage_level && !kept[pvi]; inner++)
+      {
+        kept[pvi] = mask_nest.at(pvi).test(inner);
+      }
+    }
+    return kept;
+  }
+
+  //
+  // LoopsCommute()
+  //   Two adjacent temporal loops can be swapped without changing the reuse
+  //   of a dataspace if neither of them indexes it (its tile does not move
+  //   across either loop), or if both index it on their own (every step of
+  //   either loop moves to a disjoint tile). Loops that index it together
+  //   with other dimensions, e.g. a sliding window, commute with nothing.
+  //
+  bool LoopsCommute(problem::Shape::DimensionID a, problem::Shape::DimensionID b,
+                    const std::vector<bool>& dataspaces)
+  {
+    for (unsigned pvi = 0; pvi < dataspaces.size(); pvi++)
+    {
+      if (!dataspaces[pvi])
+        continue;
+
+      auto indexing_a = dimension_indexing_.at(pvi).at(a);
+      auto indexing_b = dimension_indexing_.at(pvi).at(b);
+      if (indexing_a != indexing_b || indexing_a == Indexing::Compound)
+        return false;
+    }
+    return true;
+  }
+
   //------------------------------------------//
   //                 Parsing                  // 
   //------------------------------------------//
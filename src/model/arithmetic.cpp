@@ -32,7 +32,7 @@
 //BOOST_CLASS_EXPORT(model::ArithmeticUnits::Specs)
 BOOST_CLASS_EXPORT(model::ArithmeticUnits)
 
-#include "pat/pat.hpp"
+#include "model/pat-tables.hpp"
 
 namespace model
 {
@@ -45,9 +45,11 @@ ArithmeticUnits::ArithmeticUnits(const Specs& specs) :
   area_ = specs_.area.Get();
 }
 
-ArithmeticUnits::Specs ArithmeticUnits::ParseSpecs(config::CompoundConfigNode setting, uint32_t nElements)
+ArithmeticUnits::Specs ArithmeticUnits::ParseSpecs(config::CompoundConfigNode setting, uint32_t nElements,
+                                                   std::shared_ptr<const tech::Tables> tables)
 {
   Specs specs;
+  specs.tables = tables;
 
   // Name.
   std::string name = "__ARITH__";
@@ -127,7 +129,7 @@ ArithmeticUnits::Specs ArithmeticUnits::ParseSpecs(config::CompoundConfigNode se
   else
   {
     specs.energy_per_op =
-      pat::MultiplierEnergy(specs.word_bits.Get(), specs.word_bits.Get());
+      tech::MultiplierEnergy(tables.get(), specs.word_bits.Get(), specs.word_bits.Get());
   }
     
   // Area (override).
@@ -144,7 +146,7 @@ ArithmeticUnits::Specs ArithmeticUnits::ParseSpecs(config::CompoundConfigNode se
   else
   {
     specs.area =
-      pat::MultiplierArea(specs.word_bits.Get(), specs.word_bits.Get());
+      tech::MultiplierArea(tables.get(), specs.word_bits.Get(), specs.word_bits.Get());
   }
 
   // Validation.
@@ -38,7 +38,7 @@
 namespace model
 {
 
-class ArithmeticUnits : public Level
+class ArithmeticUnits final : public Level
 {
  public:
   struct Specs : public LevelSpecs
@@ -124,7 +124,8 @@ class ArithmeticUnits : public Level
   // The hierarchical ParseSpecs functions are static and do not
   // affect the internal specs_ data structure, which is set by
   // the dynamic Spec() call later.
-  static Specs ParseSpecs(config::CompoundConfigNode setting, uint32_t nElements);
+  static Specs ParseSpecs(config::CompoundConfigNode setting, uint32_t nElements,
+                          std::shared_ptr<const tech::Tables> tables);
   static void ValidateTopology(ArithmeticUnits::Specs& specs);
   
   Specs& GetSpecs() { return specs_; }
@@ -152,7 +153,7 @@ class ArithmeticUnits : public Level
     (void) working_set_sizes;
     (void) mask;
     (void) break_on_failure;
-    return { true, "" };
+    return EvalStatus();
   }
 
   EvalStatus Evaluate(const tiling::CompoundTile& tile, const tiling::CompoundMask& mask,
@@ -163,7 +164,9 @@ class ArithmeticUnits : public Level
     (void) mask;
     (void) compute_cycles;
     (void) break_on_failure;
-    return { false, "ArithmeticLevel must use the HackEvaluate() function" };
+    EvalStatus eval_status;
+    eval_status.Fail(EvalStatus::HackEvaluateRequired);
+    return eval_status;
   }
   
   std::uint64_t Accesses(problem::Shape::DataSpaceID pv = problem::GetShape()->NumDataSpaces) const override
@@ -188,7 +191,6 @@ class ArithmeticUnits : public Level
     assert(is_specced_);
 
     EvalStatus eval_status;
-    eval_status.success = true;
 
     auto body_info = analysis->GetBodyInfo();
     
@@ -214,11 +216,9 @@ class ArithmeticUnits : public Level
     }
     else
     {
-      eval_status.success = false;
-      std::ostringstream str;
-      str << "mapped Arithmetic instances " << utilized_instances_
-          << " exceeds hardware instances " << specs_.instances.Get();
-      eval_status.fail_reason = str.str();
+      eval_status.Fail(EvalStatus::ArithmeticInstancesExceeded);
+      eval_status.mapped_instances = utilized_instances_;
+      eval_status.available_instances = specs_.instances.Get();
     }
     
     return eval_status;
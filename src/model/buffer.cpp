@@ -38,7 +38,7 @@ BOOST_CLASS_EXPORT(model::BufferLevel)
 
 #include "util/numeric.hpp"
 #include "util/misc.hpp"
-#include "pat/pat.hpp"
+#include "model/pat-tables.hpp"
 
 namespace model
 {
@@ -51,10 +51,27 @@ BufferLevel::BufferLevel()
 { }
 
 BufferLevel::BufferLevel(const Specs& specs) :
+    BufferLevel(std::make_shared<const Specs>(specs))
+{ }
+
+BufferLevel::BufferLevel(std::shared_ptr<const Specs> specs) :
     specs_(specs)
 {
   is_specced_ = true;
   is_evaluated_ = false;
+
+  // Address-generation energy is spec-only if the user provided it, or if
+  // the buffer size (and hence the address width) is known.
+  if (specs_->addr_gen_energy.Get() >= 0.0)
+  {
+    energy_constants_.addr_gen = specs_->addr_gen_energy.Get();
+  }
+  else if (specs_->size.IsSpecified())
+  {
+    double address_range = std::ceil(static_cast<double>(specs_->size.Get() / specs_->block_size.Get()));
+    auto addr_gen_bits = static_cast<unsigned long>(std::ceil(std::log2(address_range)));
+    energy_constants_.addr_gen = tech::AdderEnergy(specs_->tables.get(), addr_gen_bits, addr_gen_bits);
+  }
 }
 
 BufferLevel::~BufferLevel()
@@ -63,11 +80,13 @@ BufferLevel::~BufferLevel()
 // The hierarchical ParseSpecs functions are static and do not
 // affect the internal specs_ data structure, which is set by
 // the dynamic Spec() call later.
-BufferLevel::Specs BufferLevel::ParseSpecs(config::CompoundConfigNode level, uint32_t n_elements)
+BufferLevel::Specs BufferLevel::ParseSpecs(config::CompoundConfigNode level, uint32_t n_elements,
+                                           std::shared_ptr<const tech::Tables> tables)
 {
   auto& buffer = level;
 
   Specs specs;
+  specs.tables = tables;
 
   // Name. This has to go first. Since the rest can be attributes
   std::string name;
@@ -286,7 +305,7 @@ BufferLevel::Specs BufferLevel::ParseSpecs(config::CompoundConfigNode level, uin
   if (specs.technology.Get() == Technology::DRAM)
   {
     assert(specs.cluster_size.Get() == 1);
-    tmp_access_energy = pat::DRAMEnergy(specs.word_bits.Get() * specs.block_size.Get());
+    tmp_access_energy = tech::DRAMEnergy(tables.get(), specs.word_bits.Get() * specs.block_size.Get());
     tmp_storage_area = 0;
   }
   else if (specs.size.Get() == 0)
@@ -306,8 +325,8 @@ BufferLevel::Specs BufferLevel::ParseSpecs(config::CompoundConfigNode level, uin
       (tmp_entries % tmp_block_size == 0) ?
       (tmp_entries / tmp_block_size)      :
       (tmp_entries / tmp_block_size) + 1;  
-    tmp_access_energy = pat::SRAMEnergy(height, width, specs.num_banks.Get(), specs.num_ports.Get()) / tmp_cluster_size;
-    tmp_storage_area = pat::SRAMArea(height, width, specs.num_banks.Get(), specs.num_ports.Get()) / tmp_cluster_size;
+    tmp_access_energy = tech::SRAMEnergy(tables.get(), height, width, specs.num_banks.Get(), specs.num_ports.Get()) / tmp_cluster_size;
+    tmp_storage_area = tech::SRAMArea(tables.get(), height, width, specs.num_banks.Get(), specs.num_ports.Get()) / tmp_cluster_size;
     // std::cout << "Entries = " << tmp_entries
     //           << ", word_size = " << tmp_word_bits
     //           << ", block_size = " << tmp_block_size
@@ -433,20 +452,19 @@ EvalStatus BufferLevel::PreEvaluationCheck(
 {
   (void) break_on_failure;
 
-  bool success = true;
-  std::ostringstream fail_reason;
+  EvalStatus eval_status;
   
-  if (specs_.size.IsSpecified())
+  if (specs_->size.IsSpecified())
   {
     // Ugh. If we can do a distributed multicast from this level,
     // then the required size may be smaller. However, that depends
     // on the multicast factor etc. that we don't know at this point.
     // Use a very loose filter and fail this check only if there's
     // no chance that this mapping can fit.
-    auto available_capacity = specs_.effective_size.Get();
+    auto available_capacity = specs_->effective_size.Get();
     if (network_read_->DistributedMulticastSupported())
     {
-      available_capacity *= specs_.instances.Get();
+      available_capacity *= specs_->instances.Get();
     }
 
     // Find the total capacity required by all un-masked data types.
@@ -461,23 +479,19 @@ EvalStatus BufferLevel::PreEvaluationCheck(
 
     if (required_capacity > available_capacity)
     {
-      success = false;
-      fail_reason << "mapped tile size " << required_capacity << " exceeds buffer capacity "
-                  << available_capacity;
+      eval_status.Fail(EvalStatus::CapacityExceeded);
+      eval_status.mapped_size = required_capacity;
+      eval_status.capacity = available_capacity;
     }
-    else if (required_capacity < specs_.effective_size.Get()
-             * specs_.min_utilization.Get())
+    else if (required_capacity < specs_->effective_size.Get()
+             * specs_->min_utilization.Get())
     {
-      success = false;
-      fail_reason << "mapped tile size " << required_capacity << " is less than constrained "
-                  << "minimum utilization " << specs_.effective_size.Get() * specs_.min_utilization.Get();
+      eval_status.Fail(EvalStatus::UtilizationTooLow);
+      eval_status.mapped_size = required_capacity;
+      eval_status.min_utilized_capacity = specs_->effective_size.Get() * specs_->min_utilization.Get();
     }
   }
 
-  EvalStatus eval_status;
-  eval_status.success = success;
-  eval_status.fail_reason = fail_reason.str();
-
   return eval_status;  
 }
 
@@ -488,23 +502,39 @@ EvalStatus BufferLevel::PreEvaluationCheck(
 EvalStatus BufferLevel::Evaluate(const tiling::CompoundTile& tile, const tiling::CompoundMask& mask,
                                  const std::uint64_t compute_cycles,
                                  const bool break_on_failure)
+{
+  auto eval_status = EvaluateAccesses(tile, mask, compute_cycles, break_on_failure);
+  if (!break_on_failure || eval_status.success)
+  {
+    ComputeEnergy();
+  }
+  return eval_status;
+}
+
+EvalStatus BufferLevel::EvaluateAccesses(const tiling::CompoundTile& tile, const tiling::CompoundMask& mask,
+                                         const std::uint64_t compute_cycles,
+                                         const bool break_on_failure)
 {
   auto eval_status = ComputeAccesses(tile, mask, break_on_failure);
   if (!break_on_failure || eval_status.success)
   {
-    ComputeBufferEnergy();
-    ComputeReductionEnergy();
-    ComputeAddrGenEnergy();
     ComputePerformance(compute_cycles);
   }
   return eval_status;
 }
 
+void BufferLevel::ComputeEnergy()
+{
+  ComputeBufferEnergy();
+  ComputeReductionEnergy();
+  ComputeAddrGenEnergy();
+}
+
 bool BufferLevel::HardwareReductionSupported()
 {
   // FIXME: take this information from an explicit arch spec.
-  return !(specs_.technology.IsSpecified() &&
-           specs_.technology.Get() == Technology::DRAM);
+  return !(specs_->technology.IsSpecified() &&
+           specs_->technology.Get() == Technology::DRAM);
 }
 
 void BufferLevel::ConnectRead(std::shared_ptr<Network> network)
@@ -520,6 +550,8 @@ void BufferLevel::ConnectFill(std::shared_ptr<Network> network)
 void BufferLevel::ConnectUpdate(std::shared_ptr<Network> network)
 {
   network_update_ = network;
+  energy_constants_.temporal_reduction =
+    tech::AdderEnergy(specs_->tables.get(), specs_->word_bits.Get(), network_update_->WordBits());
 }
 
 void BufferLevel::ConnectDrain(std::shared_ptr<Network> network)
@@ -533,8 +565,8 @@ EvalStatus BufferLevel::ComputeAccesses(const tiling::CompoundTile& tile,
 {
   (void) break_on_failure;
 
-  bool success = true;
-  std::ostringstream fail_reason;
+  EvalStatus eval_status;
+  scratch_ = EvalScratch();
   
   // Subnest FSM should be same for each problem::Shape::DataSpaceID in the list,
   // so just copy it from datatype #0.
@@ -586,64 +618,71 @@ EvalStatus BufferLevel::ComputeAccesses(const tiling::CompoundTile& tile,
   auto total_utilized_capacity = std::accumulate(stats_.utilized_capacity.begin(),
                                                  stats_.utilized_capacity.end(),
                                                  0ULL);
-  if (!specs_.size.IsSpecified())
+  if (!specs_->size.IsSpecified())
   {
 #ifdef UPDATE_UNSPECIFIED_SPECS
-    specs_.size = std::ceil(total_utilized_capacity * specs_.multiple_buffering.Get());
+    scratch_.inferred_size = std::ceil(total_utilized_capacity * specs_->multiple_buffering.Get());
 #endif
   }
-  else if (total_utilized_capacity > specs_.effective_size.Get())
+  else if (total_utilized_capacity > specs_->effective_size.Get())
   {
-    success = false;
-    fail_reason << "mapped tile size " << total_utilized_capacity << " exceeds buffer capacity "
-                << specs_.effective_size.Get();
+    eval_status.Fail(EvalStatus::CapacityExceeded);
+    eval_status.mapped_size = total_utilized_capacity;
+    eval_status.capacity = specs_->effective_size.Get();
   }
-  else if (total_utilized_capacity < specs_.effective_size.Get()
-           * specs_.min_utilization.Get())
+  else if (total_utilized_capacity < specs_->effective_size.Get()
+           * specs_->min_utilization.Get())
   {
-    success = false;
-    fail_reason << "mapped tile size " << total_utilized_capacity << " is less than constrained "
-                << "minimum utilization " << specs_.effective_size.Get() * specs_.min_utilization.Get();
+    eval_status.Fail(EvalStatus::UtilizationTooLow);
+    eval_status.mapped_size = total_utilized_capacity;
+    eval_status.min_utilized_capacity = specs_->effective_size.Get() * specs_->min_utilization.Get();
   }
 
-  assert (specs_.block_size.IsSpecified());
+  assert (specs_->block_size.IsSpecified());
     
-  assert (specs_.cluster_size.IsSpecified());
+  assert (specs_->cluster_size.IsSpecified());
    
   // Compute address-generation bits.
-  if (specs_.size.IsSpecified())
+  if (specs_->size.IsSpecified())
   {
-    double address_range = std::ceil(static_cast<double>(specs_.size.Get() / specs_.block_size.Get()));
-    specs_.addr_gen_bits = static_cast<unsigned long>(std::ceil(std::log2(address_range)));
+    double address_range = std::ceil(static_cast<double>(specs_->size.Get() / specs_->block_size.Get()));
+    scratch_.addr_gen_bits = static_cast<unsigned long>(std::ceil(std::log2(address_range)));
   }
-  else if (specs_.technology.Get() == Technology::SRAM)
+#ifdef UPDATE_UNSPECIFIED_SPECS
+  else if (scratch_.inferred_size != 0)
+  {
+    double address_range = std::ceil(static_cast<double>(scratch_.inferred_size / specs_->block_size.Get()));
+    scratch_.addr_gen_bits = static_cast<unsigned long>(std::ceil(std::log2(address_range)));
+  }
+#endif
+  else if (specs_->technology.Get() == Technology::SRAM)
   {
     // Use utilized capacity as proxy for size.
-    double address_range = std::ceil(static_cast<double>(total_utilized_capacity / specs_.block_size.Get()));
-    specs_.addr_gen_bits = static_cast<unsigned long>(std::ceil(std::log2(address_range)));
+    double address_range = std::ceil(static_cast<double>(total_utilized_capacity / specs_->block_size.Get()));
+    scratch_.addr_gen_bits = static_cast<unsigned long>(std::ceil(std::log2(address_range)));
   }
   else // DRAM.
   {
 #ifdef FIXED_DRAM_SIZE_IF_UNSPECIFIED
     // DRAM of un-specified size, use 48-bit physical address.
-    specs_.addr_gen_bits = 48;
+    scratch_.addr_gen_bits = 48;
 #else
     // Use utilized capacity as proxy for size.
-    double address_range = std::ceil(static_cast<double>(total_utilized_capacity / specs_.block_size.Get()));
-    specs_.addr_gen_bits = static_cast<unsigned long>(std::ceil(std::log2(address_range)));
+    double address_range = std::ceil(static_cast<double>(total_utilized_capacity / specs_->block_size.Get()));
+    scratch_.addr_gen_bits = static_cast<unsigned long>(std::ceil(std::log2(address_range)));
 #endif
   }
-  if (!specs_.instances.IsSpecified())
+  if (!specs_->instances.IsSpecified())
   {
 #ifdef UPDATE_UNSPECIFIED_SPECS
-    specs_.instances = stats_.utilized_instances.Max();
+    scratch_.inferred_instances = stats_.utilized_instances.Max();
 #endif
   }
-  else if (stats_.utilized_instances.Max() > specs_.instances.Get())
+  else if (stats_.utilized_instances.Max() > specs_->instances.Get())
   {
-    success = false;
-    fail_reason << "mapped instances " << stats_.utilized_instances.Max() << " exceeds available hardware instances "
-                << specs_.instances.Get();
+    eval_status.Fail(EvalStatus::InstancesExceeded);
+    eval_status.mapped_instances = stats_.utilized_instances.Max();
+    eval_status.available_instances = specs_->instances.Get();
   }
 
   // Bandwidth constraints cannot be checked/inherited at this point
@@ -652,23 +691,24 @@ EvalStatus BufferLevel::ComputeAccesses(const tiling::CompoundTile& tile,
 
   // Compute utilized clusters.
   // FIXME: should derive this from precise spatial mapping.
+#ifdef UPDATE_UNSPECIFIED_SPECS
+  auto instances = specs_->instances.IsSpecified() ? specs_->instances.Get() : scratch_.inferred_instances;
+#else
+  auto instances = specs_->instances.Get();
+#endif
   for (unsigned pvi = 0; pvi < unsigned(problem::GetShape()->NumDataSpaces); pvi++)
   {
     auto pv = problem::Shape::DataSpaceID(pvi);
     // The following equation assumes fully condensed mapping. Do a ceil-div.
     // stats_.utilized_clusters[pv] = 1 + (stats_.utilized_instances[pv] - 1) /
-    //    specs_.cluster_size.Get();
+    //    specs_->cluster_size.Get();
     // Assume utilized instances are sprinkled uniformly across all clusters.
-    auto num_clusters = specs_.instances.Get() / specs_.cluster_size.Get();
+    auto num_clusters = instances / specs_->cluster_size.Get();
     stats_.utilized_clusters[pv] = std::min(stats_.utilized_instances[pv],
                                             num_clusters);
   }
 
-  is_evaluated_ = success;
-
-  EvalStatus eval_status;
-  eval_status.success = success;
-  eval_status.fail_reason = fail_reason.str();
+  is_evaluated_ = eval_status.success;
     
   return eval_status;
 }
@@ -682,14 +722,14 @@ void BufferLevel::ComputeBufferEnergy()
     auto pv = problem::Shape::DataSpaceID(pvi);
     auto instance_accesses = stats_.reads.at(pv) + stats_.updates.at(pv) + stats_.fills.at(pv);
 
-    auto block_size = specs_.block_size.Get();
+    auto block_size = specs_->block_size.Get();
     double vector_accesses =
       (instance_accesses % block_size == 0) ?
       (instance_accesses / block_size)      :
       (instance_accesses / block_size) + 1;
     
     double cluster_access_energy = vector_accesses *
-      specs_.vector_access_energy.Get();
+      specs_->vector_access_energy.Get();
 
     // Spread out the cost between the utilized instances in each cluster.
     // This is because all the later stat-processing is per-instance.
@@ -719,8 +759,8 @@ void BufferLevel::ComputeReductionEnergy()
     auto pv = problem::Shape::DataSpaceID(pvi);
     if (problem::GetShape()->IsReadWriteDataSpace.at(pv))
     {
-      stats_.temporal_reduction_energy[pv] = stats_.temporal_reductions[pv] * 
-        pat::AdderEnergy(specs_.word_bits.Get(), network_update_->WordBits());
+      stats_.temporal_reduction_energy[pv] = stats_.temporal_reductions[pv] *
+        energy_constants_.temporal_reduction;
     }
     else
     {
@@ -737,20 +777,18 @@ void BufferLevel::ComputeAddrGenEnergy()
   // Note! Address-generation is amortized across the cluster width.
   // We compute the per-cluster energy here. When we sum across instances,
   // we need to be careful to only count each cluster once.
+
+  // We'll use an addr-gen-bits + addr-gen-bits adder, though
+  // it's probably cheaper than that. However, we can't assume
+  // a 1-bit increment.
+  double energy_per_addr_gen = energy_constants_.addr_gen >= 0.0 ?
+    energy_constants_.addr_gen :
+    tech::AdderEnergy(specs_->tables.get(), scratch_.addr_gen_bits, scratch_.addr_gen_bits);
+
   for (unsigned pvi = 0; pvi < unsigned(problem::GetShape()->NumDataSpaces); pvi++)
   {
-    // We'll use an addr-gen-bits + addr-gen-bits adder, though
-    // it's probably cheaper than that. However, we can't assume
-    // a 1-bit increment.
     auto pv = problem::Shape::DataSpaceID(pvi);
-    if (specs_.addr_gen_energy.Get() < 0.0) { 
-      stats_.addr_gen_energy[pv] = stats_.address_generations[pv] *
-        pat::AdderEnergy(specs_.addr_gen_bits.Get(), specs_.addr_gen_bits.Get());
-    }
-    else
-    {
-       stats_.addr_gen_energy[pv] = stats_.address_generations[pv] * specs_.addr_gen_energy.Get();
-    }
+    stats_.addr_gen_energy[pv] = stats_.address_generations[pv] * energy_per_addr_gen;
   }
 }
 
@@ -782,19 +820,19 @@ void BufferLevel::ComputePerformance(const std::uint64_t compute_cycles)
   auto total_unconstrained_read_bandwidth  = std::accumulate(unconstrained_read_bandwidth.begin(),  unconstrained_read_bandwidth.end(),  0.0);
   auto total_unconstrained_write_bandwidth = std::accumulate(unconstrained_write_bandwidth.begin(), unconstrained_write_bandwidth.end(), 0.0);
 
-  if (specs_.read_bandwidth.IsSpecified() &&
-      specs_.read_bandwidth.Get() < total_unconstrained_read_bandwidth)
+  if (specs_->read_bandwidth.IsSpecified() &&
+      specs_->read_bandwidth.Get() < total_unconstrained_read_bandwidth)
   {
     stats_.slowdown =
       std::min(stats_.slowdown,
-               specs_.read_bandwidth.Get() / total_unconstrained_read_bandwidth);
+               specs_->read_bandwidth.Get() / total_unconstrained_read_bandwidth);
   }
-  if (specs_.write_bandwidth.IsSpecified() &&
-      specs_.write_bandwidth.Get() < total_unconstrained_write_bandwidth)
+  if (specs_->write_bandwidth.IsSpecified() &&
+      specs_->write_bandwidth.Get() < total_unconstrained_write_bandwidth)
   {
     stats_.slowdown =
       std::min(stats_.slowdown,
-               specs_.write_bandwidth.Get() / total_unconstrained_write_bandwidth);
+               specs_->write_bandwidth.Get() / total_unconstrained_write_bandwidth);
   }
 
   //
@@ -814,16 +852,6 @@ void BufferLevel::ComputePerformance(const std::uint64_t compute_cycles)
   // Step 4: Calculate execution cycles.
   //
   stats_.cycles = std::uint64_t(ceil(compute_cycles / stats_.slowdown));
-
-  //
-  // Step 5: Update arch specs.
-  //
-#ifdef UPDATE_UNSPECIFIED_SPECS
-  if (!specs_.read_bandwidth.IsSpecified())
-    specs_.read_bandwidth = std::accumulate(stats_.read_bandwidth.begin(), stats_.read_bandwidth.end(), 0.0);
-  if (!specs_.write_bandwidth.IsSpecified())
-    specs_.write_bandwidth = std::accumulate(stats_.write_bandwidth.begin(), stats_.write_bandwidth.end(), 0.0);
-#endif
 }
 
 //
@@ -844,20 +872,20 @@ STAT_ACCESSOR(std::uint64_t, BufferLevel, UtilizedInstances, stats_.utilized_ins
 
 std::string BufferLevel::Name() const
 {
-  return specs_.name.Get();
+  return specs_->name.Get();
 }
 
 double BufferLevel::Area() const
 {
   double area = 0;
-  area += specs_.storage_area.Get() * specs_.instances.Get();
+  area += specs_->storage_area.Get() * specs_->instances.Get();
   return area;
 }
 
 double BufferLevel::AreaPerInstance() const
 {
   double area = 0;
-  area += specs_.storage_area.Get();
+  area += specs_->storage_area.Get();
   return area;
 }
 
@@ -866,7 +894,7 @@ double BufferLevel::Size() const
   // FIXME: this is per-instance. This is inconsistent with the naming
   // convention of some of the other methods, which are summed across instances.
   double size = 0;
-  size += specs_.size.Get();
+  size += specs_->size.Get();
   return size;
 }
 
@@ -880,7 +908,7 @@ double BufferLevel::CapacityUtilization() const
       stats_.utilized_instances.at(pv);
   }
 
-  double total_capacity = Size() * specs_.instances.Get();
+  double total_capacity = Size() * specs_->instances.Get();
 
   return utilized_capacity / total_capacity;
 }
@@ -914,7 +942,7 @@ void BufferLevel::Print(std::ostream& out) const
 {
   std::string indent = "    ";
 
-  auto& specs = specs_;
+  auto& specs = *specs_;
   auto& stats = stats_;
 
   // Print level name.
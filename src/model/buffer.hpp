@@ -45,7 +45,7 @@ namespace model
 //                 BufferLevel                //
 //--------------------------------------------//
 
-class BufferLevel : public Level
+class BufferLevel final : public Level
 {
 
   //
@@ -70,7 +70,6 @@ class BufferLevel : public Level
     Attribute<Technology> technology;
     Attribute<std::uint64_t> size;
     Attribute<std::uint64_t> word_bits;
-    Attribute<std::uint64_t> addr_gen_bits;
     Attribute<std::uint64_t> block_size;
     Attribute<std::uint64_t> cluster_size;
     Attribute<std::uint64_t> instances;    
@@ -108,7 +107,6 @@ class BufferLevel : public Level
         ar& BOOST_SERIALIZATION_NVP(technology);
         ar& BOOST_SERIALIZATION_NVP(size);
         ar& BOOST_SERIALIZATION_NVP(word_bits);
-        ar& BOOST_SERIALIZATION_NVP(addr_gen_bits);
         ar& BOOST_SERIALIZATION_NVP(block_size);
         ar& BOOST_SERIALIZATION_NVP(cluster_size);
         ar& BOOST_SERIALIZATION_NVP(instances);    
@@ -191,6 +189,33 @@ class BufferLevel : public Level
     }
   };
 
+  //
+  // Per-evaluation scratch. Quantities derived from the specs and the
+  // mapping during an evaluation live here rather than in the specs, so
+  // that evaluations do not depend on each other.
+  //
+  struct EvalScratch
+  {
+    std::uint64_t addr_gen_bits = 0;
+#ifdef UPDATE_UNSPECIFIED_SPECS
+    // Architecture parameters inferred from the mapping when unspecified.
+    std::uint64_t inferred_size = 0;
+    std::uint64_t inferred_instances = 0;
+#endif
+  };
+
+  //
+  // Energy constants that depend only on the specs and the connected
+  // networks. They are resolved once, by the constructor and ConnectUpdate(),
+  // so that evaluation only scales them by access counts.
+  //
+  struct EnergyConstants
+  {
+    double temporal_reduction = 0; // pJ per temporal reduction.
+    double addr_gen = -1;          // pJ per address generation; < 0 if it
+                                   // depends on the mapping's address range.
+  };
+
   //
   // Data
   //
@@ -199,7 +224,13 @@ class BufferLevel : public Level
 
   std::vector<loop::Descriptor> subnest_;
   Stats stats_;
-  Specs specs_;
+  EvalScratch scratch_;
+  EnergyConstants energy_constants_;
+
+  // Specs are read-only once the level is constructed, and are shared
+  // between copies (clones) of this level and between levels constructed
+  // from the same Topology::Specs.
+  std::shared_ptr<const Specs> specs_;
 
   // Network endpoints.
   std::shared_ptr<Network> network_read_;
@@ -216,7 +247,13 @@ class BufferLevel : public Level
     if (version == 0)
     {
       ar& BOOST_SERIALIZATION_NVP(subnest_);
-      ar& BOOST_SERIALIZATION_NVP(specs_);
+      // Specs are shared and read-only, so go through a private copy.
+      Specs specs = specs_ ? *specs_ : Specs();
+      ar& boost::serialization::make_nvp("specs_", specs);
+      if (Archive::is_loading::value)
+      {
+        specs_ = std::make_shared<const Specs>(specs);
+      }
       ar& BOOST_SERIALIZATION_NVP(stats_);
     }
   }
@@ -244,6 +281,7 @@ class BufferLevel : public Level
  public:
   BufferLevel();
   BufferLevel(const Specs & specs);
+  BufferLevel(std::shared_ptr<const Specs> specs);
   ~BufferLevel();
 
   std::shared_ptr<Level> Clone() const override
@@ -254,12 +292,13 @@ class BufferLevel : public Level
   // The hierarchical ParseSpecs functions are static and do not
   // affect the internal specs_ data structure, which is set by
   // the constructor when an object is actually created.
-  static Specs ParseSpecs(config::CompoundConfigNode setting, uint32_t n_elements);
+  static Specs ParseSpecs(config::CompoundConfigNode setting, uint32_t n_elements,
+                          std::shared_ptr<const tech::Tables> tables);
   static void ParseBufferSpecs(config::CompoundConfigNode buffer, uint32_t n_elements,
                                problem::Shape::DataSpaceID pv, Specs& specs);
   static void ValidateTopology(BufferLevel::Specs& specs);
 
-  Specs& GetSpecs() { return specs_; }
+  const Specs& GetSpecs() const { return *specs_; }
   
   bool HardwareReductionSupported() override;
 
@@ -279,6 +318,13 @@ class BufferLevel : public Level
                       const std::uint64_t compute_cycles,
                       const bool break_on_failure) override;
 
+  // Evaluate() in two steps: accesses and performance, then energy. Lets the
+  // topology skip the energy of mappings nobody asks it for.
+  EvalStatus EvaluateAccesses(const tiling::CompoundTile& tile, const tiling::CompoundMask& mask,
+                              const std::uint64_t compute_cycles,
+                              const bool break_on_failure);
+  void ComputeEnergy();
+
   // Accessors (post-evaluation).
   
   double Energy(problem::Shape::DataSpaceID pv = problem::GetShape()->NumDataSpaces) const override;
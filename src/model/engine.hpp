@@ -34,6 +34,7 @@
 #include "model/model-base.hpp"
 #include "model/arithmetic.hpp"
 #include "model/topology.hpp"
+#include "model/pat-tables.hpp"
 #include "mapping/mapping.hpp"
 #include "loop-analysis/nest-analysis.hpp"
 #include "compound-config/compound-config.hpp"
@@ -58,6 +59,9 @@ class Engine : public Module
 
   // Utilities.
   analysis::NestAnalysis nest_analysis_;
+
+  // Scratch space for tile post-processing, reused across evaluations.
+  tiling::TilePipelineBuffers tile_buffers_;
   
   // Serialization.
   friend class boost::serialization::access;
@@ -80,16 +84,29 @@ class Engine : public Module
     Specs specs;
     std::string version;
 
+    // Technology tables are parsed with, and kept by, this architecture's
+    // level and network specs.
+    std::shared_ptr<const tech::Tables> tables;
+    std::string pat_tables;
+    if (setting.lookupValue("pat-tables", pat_tables))
+    {
+      tables = tech::Tables::Load(pat_tables);
+    }
+    else
+    {
+      tables = tech::Tables::Default();
+    }
+
     if (!setting.exists("version") || (setting.lookupValue("version", version) && (version != "0.2" && version != "0.3"))) {
       // format used in the ISPASS paper
       // std::cout << "ParseSpecs" << std::endl;
       auto arithmetic = setting.lookup("arithmetic");
       auto topology = setting.lookup("storage");
-      specs.topology = Topology::ParseSpecs(topology, arithmetic);
+      specs.topology = Topology::ParseSpecs(topology, arithmetic, tables);
     } else {
       // format used in Accelergy v0.2/v0.3
       // std::cout << "ParseTreeSpecs" << std::endl;
-      specs.topology = Topology::ParseTreeSpecs(setting);
+      specs.topology = Topology::ParseTreeSpecs(setting, tables);
     }
 
     return specs;
@@ -104,17 +121,26 @@ class Engine : public Module
 
   const Topology& GetTopology() const { return topology_; }
 
-  std::vector<EvalStatus> PreEvaluationCheck(const Mapping& mapping, problem::Workload& workload, bool break_on_failure = true)
+  const std::vector<EvalStatus>& PreEvaluationCheck(const Mapping& mapping, problem::Workload& workload,
+                                                    bool break_on_failure = true)
   {
     nest_analysis_.Init(&workload, &mapping.loop_nest);
-    return topology_.PreEvaluationCheck(mapping, &nest_analysis_, break_on_failure);
+    return topology_.PreEvaluationCheck(mapping, &nest_analysis_, tile_buffers_, break_on_failure);
   }
 
-  std::vector<EvalStatus> Evaluate(Mapping& mapping, problem::Workload& workload, bool break_on_failure = true)
+  // The budget bounds the loop-nest analysis; if it runs out, every level
+  // reports failure and LastAbortReason() says why. The stats mask selects
+  // the optional stats (see Topology::StatsMask); CompleteStats() fills in
+  // the rest for a mapping worth keeping.
+  const std::vector<EvalStatus>& Evaluate(Mapping& mapping, problem::Workload& workload, bool break_on_failure = true,
+                                          const analysis::EvalBudget& budget = analysis::EvalBudget(),
+                                          unsigned stats_mask = Topology::StatsAll)
   {
+    nest_analysis_.SetBudget(budget);
     nest_analysis_.Init(&workload, &mapping.loop_nest);
     
-    auto eval_status = topology_.Evaluate(mapping, &nest_analysis_, workload, break_on_failure);
+    auto& eval_status = topology_.Evaluate(mapping, &nest_analysis_, workload, tile_buffers_, break_on_failure,
+                                           stats_mask);
 
     is_evaluated_ = std::accumulate(eval_status.begin(), eval_status.end(), true,
                                     [](bool cur, const EvalStatus& status)
@@ -123,6 +149,16 @@ class Engine : public Module
     return eval_status;
   }
   
+  void CompleteStats()
+  {
+    topology_.CompleteStats();
+  }
+
+  analysis::AbortReason LastAbortReason() const
+  {
+    return nest_analysis_.GetAbortReason();
+  }
+
   double Energy() const
   {
     return topology_.Energy();
@@ -27,16 +27,106 @@
 
 #pragma once
 
+#include <sstream>
+
 #include "model/model-base.hpp"
+#include "model/pat-tables.hpp"
 #include "loop-analysis/tiling.hpp"
 
 namespace model
 {
 
+// Outcome of evaluating one level. Most mappings fail some check, so a
+// failure is recorded as a set of codes plus the numbers that explain it;
+// the human-readable text is only built by FailReason() when a diagnostic
+// is actually emitted.
 struct EvalStatus
 {
-  bool success;
-  std::string fail_reason;
+  // A level can fail more than one check, so the codes are bit flags.
+  enum Failure : std::uint16_t
+  {
+    None                        = 0,
+    CapacityExceeded            = 1 << 0, // mapped_size > capacity
+    UtilizationTooLow           = 1 << 1, // mapped_size < min_utilized_capacity
+    InstancesExceeded           = 1 << 2, // mapped_instances > available_instances
+    ArithmeticInstancesExceeded = 1 << 3, // mapped_instances > available_instances
+    HackEvaluateRequired        = 1 << 4,
+    BudgetExceeded              = 1 << 5,
+    Cancelled                   = 1 << 6
+  };
+
+  bool success = true;
+  std::uint16_t failures = None;
+
+  // Failure payload.
+  std::uint64_t mapped_size = 0;
+  std::uint64_t capacity = 0;
+  double min_utilized_capacity = 0;
+  std::uint64_t mapped_instances = 0;
+  std::uint64_t available_instances = 0;
+
+  void Fail(Failure failure)
+  {
+    success = false;
+    failures |= failure;
+  }
+
+  // Folds in the status of another component (e.g., a network) that is
+  // reported against this level.
+  void Merge(const EvalStatus& other)
+  {
+    if (other.failures & (CapacityExceeded | UtilizationTooLow))
+    {
+      mapped_size = other.mapped_size;
+      capacity = other.capacity;
+      min_utilized_capacity = other.min_utilized_capacity;
+    }
+    if (other.failures & (InstancesExceeded | ArithmeticInstancesExceeded))
+    {
+      mapped_instances = other.mapped_instances;
+      available_instances = other.available_instances;
+    }
+    success &= other.success;
+    failures |= other.failures;
+  }
+
+  std::string FailReason() const
+  {
+    std::ostringstream str;
+    if (failures & CapacityExceeded)
+    {
+      str << "mapped tile size " << mapped_size << " exceeds buffer capacity "
+          << capacity;
+    }
+    if (failures & UtilizationTooLow)
+    {
+      str << "mapped tile size " << mapped_size << " is less than constrained "
+          << "minimum utilization " << min_utilized_capacity;
+    }
+    if (failures & InstancesExceeded)
+    {
+      str << "mapped instances " << mapped_instances << " exceeds available hardware instances "
+          << available_instances;
+    }
+    if (failures & ArithmeticInstancesExceeded)
+    {
+      str << "mapped Arithmetic instances " << mapped_instances
+          << " exceeds hardware instances " << available_instances;
+    }
+    if (failures & HackEvaluateRequired)
+    {
+      str << "ArithmeticLevel must use the HackEvaluate() function";
+    }
+    if (failures & BudgetExceeded)
+    {
+      str << "evaluation budget exceeded";
+    }
+    if (failures & Cancelled)
+    {
+      str << "evaluation cancelled";
+    }
+    return str.str();
+  }
 };
 
 //--------------------------------------------//
@@ -53,6 +143,9 @@ struct LevelSpecs
 
   std::string level_name;
 
+  // Technology tables of the architecture (not serialized).
+  std::shared_ptr<const tech::Tables> tables;
+
   // Serialization
   friend class boost::serialization::access;
 
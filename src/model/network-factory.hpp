@@ -45,7 +45,8 @@ class NetworkFactory
  public:
 
   // Parse network type and instantiate a Spec object of that network type.
-  static std::shared_ptr<NetworkSpecs> ParseSpecs(config::CompoundConfigNode network, uint32_t n_elements)
+  static std::shared_ptr<NetworkSpecs> ParseSpecs(config::CompoundConfigNode network, uint32_t n_elements,
+                                                  std::shared_ptr<const tech::Tables> tables)
   {
     std::shared_ptr<NetworkSpecs> specs;
 
@@ -54,17 +55,17 @@ class NetworkFactory
     {
       if (network_class.compare("XY_NoC") == 0 || network_class.compare("Legacy") == 0)
       {
-        auto legacy_specs = LegacyNetwork::ParseSpecs(network, n_elements);
+        auto legacy_specs = LegacyNetwork::ParseSpecs(network, n_elements, tables);
         specs = std::make_shared<LegacyNetwork::Specs>(legacy_specs);
       }
       else if (network_class.compare("ReductionTree") == 0)
       {
-        auto reduction_tree_specs = ReductionTreeNetwork::ParseSpecs(network, n_elements);
+        auto reduction_tree_specs = ReductionTreeNetwork::ParseSpecs(network, n_elements, tables);
         specs = std::make_shared<ReductionTreeNetwork::Specs>(reduction_tree_specs);
       }
       else if (network_class.compare("SimpleMulticast") == 0)
       {
-        auto simple_multicast_specs = SimpleMulticastNetwork::ParseSpecs(network, n_elements);
+        auto simple_multicast_specs = SimpleMulticastNetwork::ParseSpecs(network, n_elements, tables);
         specs = std::make_shared<SimpleMulticastNetwork::Specs>(simple_multicast_specs);
       }
 
@@ -29,7 +29,7 @@
 
 #include "model/util.hpp"
 #include "model/level.hpp"
-#include "pat/pat.hpp"
+#include "model/pat-tables.hpp"
 
 #include <boost/archive/xml_iarchive.hpp>
 #include <boost/archive/xml_oarchive.hpp>
@@ -53,11 +53,13 @@ LegacyNetwork::LegacyNetwork(const Specs& specs) :
 LegacyNetwork::~LegacyNetwork()
 { }
 
-LegacyNetwork::Specs LegacyNetwork::ParseSpecs(config::CompoundConfigNode network, std::size_t n_elements)
+LegacyNetwork::Specs LegacyNetwork::ParseSpecs(config::CompoundConfigNode network, std::size_t n_elements,
+                                               std::shared_ptr<const tech::Tables> tables)
 {
   (void) n_elements; // FIXME.
 
   Specs specs;
+  specs.tables = tables;
 
   // Network Type.
   specs.type = "Legacy";
@@ -169,12 +171,28 @@ void LegacyNetwork::SetTileWidth(double width_um)
 {
   // Only set this if user didn't specify a pre-floorplanned tile width.
   specs_.tile_width = specs_.tile_width.IsSpecified() ? specs_.tile_width.Get() : width_um;
+
+  // WireEnergyPerHop checks if wire energy is 0.0 before using default pat
+  double wire_energy = specs_.wire_energy.IsSpecified() ? specs_.wire_energy.Get() : 0.0;
+  energy_per_hop_ =
+    specs_.energy_per_hop.IsSpecified() ?
+    specs_.energy_per_hop.Get() : WireEnergyPerHop(specs_.tables.get(), specs_.word_bits.Get(), specs_.tile_width.Get(), wire_energy);
+  energy_per_router_ = specs_.router_energy.IsSpecified() ? specs_.router_energy.Get() : 0.0; // Set to 0 since no internal model yet
+  spatial_reduction_energy_per_op_ = tech::AdderEnergy(specs_.tables.get(), specs_.word_bits.Get(), specs_.word_bits.Get());
+  memo_.clear();
 }
 
 // Evaluate.
 EvalStatus LegacyNetwork::Evaluate(const tiling::CompoundTile& tile,
                                  const bool break_on_failure)
 {
+  auto signature = tiling::NetworkSignature(tile);
+  if (auto stats = memo_.Find(signature, tile))
+  {
+    stats_ = *stats;
+    is_evaluated_ = true;
+    return EvalStatus();
+  }
 
   auto eval_status = ComputeAccesses(tile, break_on_failure);
   if (!break_on_failure || eval_status.success)
@@ -183,13 +201,16 @@ EvalStatus LegacyNetwork::Evaluate(const tiling::CompoundTile& tile,
     ComputeSpatialReductionEnergy();
     ComputePerformance();
   }
+  if (eval_status.success)
+  {
+    memo_.Insert(signature, tile, stats_);
+  }
   return eval_status;
 }
 
 EvalStatus LegacyNetwork::ComputeAccesses(const tiling::CompoundTile& tile, const bool break_on_failure)
 {
-  bool success = true;
-  std::ostringstream fail_reason;
+  EvalStatus eval_status;
 
   //
   // 1. Collect stats (stats are always collected per-DataSpaceID).
@@ -218,21 +239,17 @@ EvalStatus LegacyNetwork::ComputeAccesses(const tiling::CompoundTile& tile, cons
         if (sink->HardwareReductionSupported() ||
             (specs_.cType == ConnectionType::ReadFill) )
         {
-          stats_.ingresses[pv] = tile[pvi].accesses;
+          stats_.ingresses[pv] = tile[pvi].accesses.Dense(tile[pvi].GetMulticastRange());
         }
         else
         {
-          stats_.ingresses[pv].resize(tile[pvi].accesses.size());
-          for (unsigned i = 0; i < tile[pvi].accesses.size(); i++)
+          stats_.ingresses[pv].assign(tile[pvi].GetMulticastRange(), 0);
+          for (auto& entry : tile[pvi].accesses)
           {
-            if (tile[pvi].accesses[i] > 0)
-            {
-              assert(tile[pvi].size == 0 || tile[pvi].accesses[i] % tile[pvi].size == 0);
-              stats_.ingresses[pv][i] = 2*tile[pvi].accesses[i] - tile[pvi].partition_size;
-            }
-            else
+            if (entry.second > 0)
             {
-              stats_.ingresses[pv][i] = 0;
+              assert(tile[pvi].size == 0 || entry.second % tile[pvi].size == 0);
+              stats_.ingresses[pv][entry.first - 1] = 2*entry.second - tile[pvi].partition_size;
             }
           }
         } // hardware reduction not supported
@@ -248,17 +265,19 @@ EvalStatus LegacyNetwork::ComputeAccesses(const tiling::CompoundTile& tile, cons
     }
     else // Read-only data space.
     {
-      stats_.ingresses[pv] = tile[pvi].accesses;
+      stats_.ingresses[pv] = tile[pvi].accesses.Dense(tile[pvi].GetMulticastRange());
     }
 
     stats_.spatial_reductions[pv] = 0;
     stats_.distributed_multicast[pv] = tile[pvi].distributed_multicast;
-    stats_.avg_hops[pv].resize(tile[pvi].accesses.size());
-    for (unsigned i = 0; i < tile[pvi].accesses.size(); i++)
+    stats_.avg_hops[pv].assign(tile[pvi].GetMulticastRange(), 0);
+    for (auto& entry : tile[pvi].accesses)
     {
-      if (tile[pvi].accesses[i] > 0)
+      if (entry.second > 0)
       {
-        stats_.avg_hops[pv][i] = tile[pvi].cumulative_hops[i] / double(tile[pvi].scatter_factors[i]);
+        auto multicast_factor = entry.first;
+        stats_.avg_hops[pv][multicast_factor - 1] = tile[pvi].cumulative_hops.Get(multicast_factor) /
+          double(tile[pvi].scatter_factors.Get(multicast_factor));
       }
     }
     
@@ -310,11 +329,7 @@ EvalStatus LegacyNetwork::ComputeAccesses(const tiling::CompoundTile& tile, cons
     // this later in the ComputePerformance() function.    
 
   (void) break_on_failure;
-  is_evaluated_ = success;
-
-  EvalStatus eval_status;
-  eval_status.success = success;
-  eval_status.fail_reason = fail_reason.str();
+  is_evaluated_ = eval_status.success;
     
   return eval_status;
 
@@ -335,12 +350,8 @@ void LegacyNetwork::ComputeNetworkEnergy()
   for (unsigned pvi = 0; pvi < unsigned(problem::GetShape()->NumDataSpaces); pvi++)
   {
     auto pv = problem::Shape::DataSpaceID(pvi);
-    // WireEnergyPerHop checks if wire energy is 0.0 before using default pat
-    double wire_energy = specs_.wire_energy.IsSpecified() ? specs_.wire_energy.Get() : 0.0;
-    double energy_per_hop =
-      specs_.energy_per_hop.IsSpecified() ?
-      specs_.energy_per_hop.Get() : WireEnergyPerHop(specs_.word_bits.Get(), specs_.tile_width.Get(), wire_energy);
-    double energy_per_router = specs_.router_energy.IsSpecified() ? specs_.router_energy.Get() : 0.0; // Set to 0 since no internal model yet
+    double energy_per_hop = energy_per_hop_;
+    double energy_per_router = energy_per_router_;
     
     auto fanout = stats_.distributed_multicast.at(pv) ?
       stats_.distributed_fanout.at(pv) :
@@ -424,8 +435,8 @@ void LegacyNetwork::ComputeSpatialReductionEnergy()
     if (problem::GetShape()->IsReadWriteDataSpace.at(pv)
             && (specs_.cType & ConnectionType::UpdateDrain)) // also used for UpdateDrain connections
     {
-      stats_.spatial_reduction_energy[pv] = stats_.spatial_reductions[pv] * 
-        pat::AdderEnergy(specs_.word_bits.Get(), specs_.word_bits.Get());
+      stats_.spatial_reduction_energy[pv] = stats_.spatial_reductions[pv] *
+        spatial_reduction_energy_per_op_;
     }
     else
     {
@@ -544,7 +555,7 @@ void LegacyNetwork::Print(std::ostream& out) const
 //
 // PAT interface.
 //
-double LegacyNetwork::WireEnergyPerHop(std::uint64_t word_bits, const double hop_distance,
+double LegacyNetwork::WireEnergyPerHop(const tech::Tables* tables, std::uint64_t word_bits, const double hop_distance,
                                        double wire_energy_override)
 {
   double hop_distance_mm = hop_distance / 1000;
@@ -555,7 +566,7 @@ double LegacyNetwork::WireEnergyPerHop(std::uint64_t word_bits, const double hop
   }
   else
   {
-    return pat::WireEnergy(word_bits, hop_distance_mm);
+    return tech::WireEnergy(tables, word_bits, hop_distance_mm);
   }
 }
 
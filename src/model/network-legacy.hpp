@@ -143,6 +143,15 @@ class LegacyNetwork : public Network
   std::weak_ptr<Level> source_;
   std::weak_ptr<Level> sink_;
 
+  // Energy constants that depend only on the specs, resolved once the tile
+  // width is final (SetTileWidth()) so that evaluation only scales them.
+  double energy_per_hop_ = 0;
+  double energy_per_router_ = 0;
+  double spatial_reduction_energy_per_op_ = 0;
+
+  // Stats of recently seen tiles (see NetworkStatsMemo).
+  NetworkStatsMemo<Stats> memo_;
+
  public:
   Stats stats_; // temporarily public.
 
@@ -174,7 +183,8 @@ class LegacyNetwork : public Network
     return std::static_pointer_cast<Network>(std::make_shared<LegacyNetwork>(*this));
   }
 
-  static Specs ParseSpecs(config::CompoundConfigNode network, std::size_t n_elements);
+  static Specs ParseSpecs(config::CompoundConfigNode network, std::size_t n_elements,
+                          std::shared_ptr<const tech::Tables> tables);
 
   void ConnectSource(std::weak_ptr<Level> source);
   void ConnectSink(std::weak_ptr<Level> sink);
@@ -201,7 +211,7 @@ class LegacyNetwork : public Network
   void Print(std::ostream& out) const;
 
   // PAT interface.
-  static double WireEnergyPerHop(std::uint64_t word_bits, const double hop_distance, double wire_energy_override);
+  static double WireEnergyPerHop(const tech::Tables* tables, std::uint64_t word_bits, const double hop_distance, double wire_energy_override);
   static double NumHops(std::uint32_t multicast_factor, std::uint32_t fanout);
 
   STAT_ACCESSOR_HEADER(double, NetworkEnergy);
@@ -29,7 +29,7 @@
 
 #include "model/util.hpp"
 #include "model/level.hpp"
-#include "pat/pat.hpp"
+#include "model/pat-tables.hpp"
 
 #include <boost/archive/xml_iarchive.hpp>
 #include <boost/archive/xml_oarchive.hpp>
@@ -53,11 +53,13 @@ ReductionTreeNetwork::ReductionTreeNetwork(const Specs& specs) :
 ReductionTreeNetwork::~ReductionTreeNetwork()
 { }
 
-ReductionTreeNetwork::Specs ReductionTreeNetwork::ParseSpecs(config::CompoundConfigNode network, std::size_t n_elements)
+ReductionTreeNetwork::Specs ReductionTreeNetwork::ParseSpecs(config::CompoundConfigNode network, std::size_t n_elements,
+                                                             std::shared_ptr<const tech::Tables> tables)
 {
   (void) n_elements; // FIXME.
 
   Specs specs;
+  specs.tables = tables;
 
   // Network Type.
   specs.type = "ReductionTree";
@@ -146,6 +148,11 @@ void ReductionTreeNetwork::SetTileWidth(double width_um)
   {
     specs_.tile_width = width_um;
   }
+
+  energy_per_hop_ =
+    WireEnergyPerHop(specs_.tables.get(), specs_.word_bits.Get(), specs_.tile_width.Get(), specs_.wire_energy.Get());
+  adder_energy_per_op_ = AdderEnergy(specs_.tables.get(), specs_.word_bits.Get(), specs_.adder_energy.Get());
+  memo_.clear();
 }
 
 EvalStatus ReductionTreeNetwork::Evaluate(const tiling::CompoundTile& tile,
@@ -154,6 +161,15 @@ EvalStatus ReductionTreeNetwork::Evaluate(const tiling::CompoundTile& tile,
   (void) break_on_failure;
   assert(specs_.cType == UpdateDrain); // ReductionTreeNetwork can only be used in update-drain connection
 
+  EvalStatus eval_status;
+  auto signature = tiling::NetworkSignature(tile);
+  if (auto stats = memo_.Find(signature, tile))
+  {
+    stats_ = *stats;
+    is_evaluated_ = true;
+    return eval_status;
+  }
+
   // Get stats from the CompoundTile
   for (unsigned pvi = 0; pvi < unsigned(problem::GetShape()->NumDataSpaces); pvi++)
   {
@@ -163,11 +179,11 @@ EvalStatus ReductionTreeNetwork::Evaluate(const tiling::CompoundTile& tile,
 
     if (problem::GetShape()->IsReadWriteDataSpace.at(pv))
     {
-      stats_.ingresses[pv].resize(tile[pvi].accesses.size());
-      for (unsigned i = 0; i < tile[pvi].accesses.size(); i++)
+      stats_.ingresses[pv] = tile[pvi].accesses.Dense(tile[pvi].GetMulticastRange());
+      stats_.spatial_reductions[pv] = 0;
+      for (auto& entry : tile[pvi].accesses)
       {
-        stats_.ingresses[pv][i] = tile[pvi].accesses[i];
-        stats_.spatial_reductions[pv] += (i * stats_.ingresses[pv][i]);
+        stats_.spatial_reductions[pv] += ((entry.first - 1) * entry.second);
       }
     }
     else // Read-only data, all zeros
@@ -181,8 +197,7 @@ EvalStatus ReductionTreeNetwork::Evaluate(const tiling::CompoundTile& tile,
   {
     auto pv = problem::Shape::DataSpaceID(pvi);
 
-    double energy_per_hop =
-      WireEnergyPerHop(specs_.word_bits.Get(), specs_.tile_width.Get(), specs_.wire_energy.Get());
+    double energy_per_hop = energy_per_hop_;
     double total_wire_hops = 0;
     double total_ingresses = 0;
     for (unsigned i = 0; i < stats_.ingresses[pv].size(); i++)
@@ -206,13 +221,12 @@ EvalStatus ReductionTreeNetwork::Evaluate(const tiling::CompoundTile& tile,
       stats_.energy_per_hop[pv] = energy_per_hop;
       stats_.num_hops[pv] = total_ingresses > 0 ? total_wire_hops / total_ingresses : 0;
       stats_.energy[pv] = total_wire_hops * energy_per_hop;
-      stats_.spatial_reduction_energy[pv] = stats_.spatial_reductions[pv] *
-          AdderEnergy(specs_.word_bits.Get(), specs_.adder_energy.Get());
+      stats_.spatial_reduction_energy[pv] = stats_.spatial_reductions[pv] * adder_energy_per_op_;
     }
   }
 
-  auto eval_status = EvalStatus{true, std::string("")};
   is_evaluated_ = true;
+  memo_.Insert(signature, tile, stats_);
   // std::cout << "ReductionNetwork::Evaluate()" << std::endl;
 
   return eval_status;
@@ -221,7 +235,7 @@ EvalStatus ReductionTreeNetwork::Evaluate(const tiling::CompoundTile& tile,
 // FIXME: Should merge this back to the common abstract Network class
 // PAT interface.
 //
-double ReductionTreeNetwork::WireEnergyPerHop(std::uint64_t word_bits, const double hop_distance,
+double ReductionTreeNetwork::WireEnergyPerHop(const tech::Tables* tables, std::uint64_t word_bits, const double hop_distance,
                                        double wire_energy_override)
 {
   double hop_distance_mm = hop_distance / 1000;
@@ -232,11 +246,11 @@ double ReductionTreeNetwork::WireEnergyPerHop(std::uint64_t word_bits, const dou
   }
   else
   {
-    return pat::WireEnergy(word_bits, hop_distance_mm);
+    return tech::WireEnergy(tables, word_bits, hop_distance_mm);
   }
 }
 
-double ReductionTreeNetwork::AdderEnergy(std::uint64_t word_bits, double adder_energy_override)
+double ReductionTreeNetwork::AdderEnergy(const tech::Tables* tables, std::uint64_t word_bits, double adder_energy_override)
 {
   if (adder_energy_override != 0.0)
   {
@@ -245,7 +259,7 @@ double ReductionTreeNetwork::AdderEnergy(std::uint64_t word_bits, double adder_e
   }
   else
   {
-    return pat::AdderEnergy(word_bits, word_bits);
+    return tech::AdderEnergy(tables, word_bits, word_bits);
   }
 }
 
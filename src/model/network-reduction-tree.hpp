@@ -124,6 +124,14 @@ class ReductionTreeNetwork : public Network
   std::weak_ptr<Level> source_;
   std::weak_ptr<Level> sink_;
 
+  // Energy constants that depend only on the specs, resolved once the tile
+  // width is final (SetTileWidth()) so that evaluation only scales them.
+  double energy_per_hop_ = 0;
+  double adder_energy_per_op_ = 0;
+
+  // Stats of recently seen tiles (see NetworkStatsMemo).
+  NetworkStatsMemo<Stats> memo_;
+
  public:
   Stats stats_; // temporarily public.
 
@@ -155,7 +163,8 @@ class ReductionTreeNetwork : public Network
     return std::static_pointer_cast<Network>(std::make_shared<ReductionTreeNetwork>(*this));
   }
   
-  static Specs ParseSpecs(config::CompoundConfigNode network, std::size_t n_elements);
+  static Specs ParseSpecs(config::CompoundConfigNode network, std::size_t n_elements,
+                          std::shared_ptr<const tech::Tables> tables);
 
   void ConnectSource(std::weak_ptr<Level> source);
   void ConnectSink(std::weak_ptr<Level> sink);
@@ -172,8 +181,8 @@ class ReductionTreeNetwork : public Network
   EvalStatus Evaluate(const tiling::CompoundTile& tile,
                               const bool break_on_failure);
   // PAT interface.
-  static double WireEnergyPerHop(std::uint64_t word_bits, const double hop_distance, double wire_energy_override);
-  static double AdderEnergy(std::uint64_t word_bits, double adder_energy_override);
+  static double WireEnergyPerHop(const tech::Tables* tables, std::uint64_t word_bits, const double hop_distance, double wire_energy_override);
+  static double AdderEnergy(const tech::Tables* tables, std::uint64_t word_bits, double adder_energy_override);
 
   void Print(std::ostream& out) const;
 
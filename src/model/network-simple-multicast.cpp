@@ -53,11 +53,13 @@ SimpleMulticastNetwork::SimpleMulticastNetwork(const Specs& specs) :
 SimpleMulticastNetwork::~SimpleMulticastNetwork()
 { }
 
-SimpleMulticastNetwork::Specs SimpleMulticastNetwork::ParseSpecs(config::CompoundConfigNode network, std::size_t n_elements)
+SimpleMulticastNetwork::Specs SimpleMulticastNetwork::ParseSpecs(config::CompoundConfigNode network, std::size_t n_elements,
+                                                                 std::shared_ptr<const tech::Tables> tables)
 {
   (void) n_elements; // FIXME.
 
   Specs specs;
+  specs.tables = tables;
 
   // Network Type.
   specs.type = "SimpleMulticast";
@@ -161,6 +163,7 @@ void SimpleMulticastNetwork::SetTileWidth(double width_um)
   {
     specs_.tile_width = width_um;
   }
+  memo_.clear();
 }
 
 double SimpleMulticastNetwork::GetOpEnergyFromERT(std::uint64_t multicast_factor, std::string operation_name){
@@ -206,9 +209,17 @@ double SimpleMulticastNetwork::GetMulticastEnergyByDataType(std::uint64_t multic
 EvalStatus SimpleMulticastNetwork::Evaluate(const tiling::CompoundTile& tile,
                               const bool break_on_failure)
 {
-  (void) tile;
   (void) break_on_failure;
 
+  EvalStatus eval_status;
+  auto signature = tiling::NetworkSignature(tile);
+  if (auto stats = memo_.Find(signature, tile))
+  {
+    stats_ = *stats;
+    is_evaluated_ = true;
+    return eval_status;
+  }
+
   // Get stats from the CompoundTile
   for (unsigned pvi = 0; pvi < unsigned(problem::GetShape()->NumDataSpaces); pvi++)
   {
@@ -216,15 +227,12 @@ EvalStatus SimpleMulticastNetwork::Evaluate(const tiling::CompoundTile& tile,
     stats_.utilized_instances[pv] = tile[pvi].replication_factor;
     stats_.fanout = tile[pvi].fanout;
     stats_.multicast_factor[pv] = 0;
+    stats_.energy[pv] = 0;
 
     std::string data_space_name = problem::GetShape()->DataSpaceIDToName.at(pvi);
     // don't care what type of connection this is
     // only need to count the number of transfers
-    stats_.ingresses[pv].resize(tile[pvi].accesses.size());
-    for (unsigned i = 0; i < tile[pvi].accesses.size(); i++)
-    {
-      stats_.ingresses[pv][i] = tile[pvi].accesses[i];
-    }
+    stats_.ingresses[pv] = tile[pvi].accesses.Dense(tile[pvi].GetMulticastRange());
     for (unsigned i = 0; i < stats_.ingresses[pv].size(); i++)
     {
       auto ingresses = stats_.ingresses.at(pv).at(i);
@@ -241,8 +249,8 @@ EvalStatus SimpleMulticastNetwork::Evaluate(const tiling::CompoundTile& tile,
     }
   }
 
-  auto eval_status = EvalStatus{true, std::string("")};
   is_evaluated_ = true;
+  memo_.Insert(signature, tile, stats_);
 
   return eval_status;
 }
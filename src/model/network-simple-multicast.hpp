@@ -122,6 +122,9 @@ class SimpleMulticastNetwork : public Network
   std::weak_ptr<Level> source_;
   std::weak_ptr<Level> sink_;
 
+  // Stats of recently seen tiles (see NetworkStatsMemo).
+  NetworkStatsMemo<Stats> memo_;
+
  public:
   Stats stats_; // temporarily public.
 
@@ -153,7 +156,8 @@ class SimpleMulticastNetwork : public Network
     return std::static_pointer_cast<Network>(std::make_shared<SimpleMulticastNetwork>(*this));
   }
   
-  static Specs ParseSpecs(config::CompoundConfigNode network, std::size_t n_elements);
+  static Specs ParseSpecs(config::CompoundConfigNode network, std::size_t n_elements,
+                          std::shared_ptr<const tech::Tables> tables);
 
   void ConnectSource(std::weak_ptr<Level> source);
   void ConnectSink(std::weak_ptr<Level> sink);
@@ -27,10 +27,12 @@
 
 #pragma once
 
+#include <array>
 #include <iostream>
 
 #include "model/util.hpp"
 #include "model/level.hpp"
+#include "model/pat-tables.hpp"
 #include "pat/pat.hpp"
 
 namespace model
@@ -58,6 +60,9 @@ struct NetworkSpecs
   std::string name = "UNSET";
   ConnectionType cType = Unused;
 
+  // Technology tables of the architecture (not serialized).
+  std::shared_ptr<const tech::Tables> tables;
+
   // Serialization
   friend class boost::serialization::access;
 
@@ -73,6 +78,55 @@ struct NetworkSpecs
 
 BOOST_SERIALIZATION_ASSUME_ABSTRACT(NetworkSpecs)
 
+//--------------------------------------------//
+//             Network stats memo             //
+//--------------------------------------------//
+
+// Once a network is specced and floorplanned, its stats are a function of
+// the tile it is evaluated on. Mappings often present a network with the
+// same tile, so each network keeps a small direct-mapped memo of its stats
+// keyed on tiling::NetworkSignature(). Each entry keeps a copy of the hashed
+// fields, so a hit is only taken when the tile itself matches.
+template <class Stats>
+class NetworkStatsMemo
+{
+ private:
+  static const std::size_t kNumEntries = 16;
+
+  struct Entry
+  {
+    bool valid = false;
+    std::uint64_t signature = 0;
+    tiling::CompoundNetworkFields fields;
+    Stats stats;
+  };
+  std::array<Entry, kNumEntries> entries_;
+
+ public:
+  const Stats* Find(std::uint64_t signature, const tiling::CompoundTile& tile) const
+  {
+    auto& entry = entries_[signature % kNumEntries];
+    bool hit = entry.valid && entry.signature == signature &&
+      tiling::MatchesNetworkFields(entry.fields, tile);
+    return hit ? &entry.stats : nullptr;
+  }
+
+  void Insert(std::uint64_t signature, const tiling::CompoundTile& tile, const Stats& stats)
+  {
+    auto& entry = entries_[signature % kNumEntries];
+    entry.valid = true;
+    entry.signature = signature;
+    tiling::AssignNetworkFields(entry.fields, tile);
+    entry.stats = stats;
+  }
+
+  void clear()
+  {
+    for (auto& entry : entries_)
+      entry.valid = false;
+  }
+};
+
 //--------------------------------------------//
 //            Network (base class)            //
 //--------------------------------------------//
@@ -102,6 +156,11 @@ class Network : public Module
   virtual EvalStatus Evaluate(const tiling::CompoundTile& tile,
                               const bool break_on_failure) = 0;
 
+  // Marks the network as not yet evaluated for the mapping about to be
+  // evaluated. Topology::Evaluate() evaluates each network at most once
+  // per mapping, even when it serves several connections.
+  void ResetEvaluation() { is_evaluated_ = false; }
+
   virtual void Print(std::ostream& out) const = 0;
 
   // Ugly abstraction-breaking probes that should be removed.
@@ -0,0 +1,332 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+
+#include "model/pat-tables.hpp"
+#include "pat/pat.hpp"
+
+namespace model
+{
+
+namespace tech
+{
+
+const std::string& TableName(TableID id)
+{
+  static const std::array<std::string, unsigned(TableID::Num)> names =
+  {
+    "sram-energy",
+    "sram-area",
+    "dram-energy",
+    "multiplier-energy",
+    "multiplier-area",
+    "adder-energy",
+    "adder-area",
+    "wire-energy"
+  };
+  return names.at(unsigned(id));
+}
+
+//
+// Table2D.
+//
+
+Table2D::Table2D(const std::string& name, const Map2D& map)
+{
+  static std::atomic<std::uint64_t> next_serial(0);
+  serial_ = next_serial++;
+
+  if (map.empty() || map.begin()->second.empty())
+  {
+    std::cerr << "ERROR: PAT table " << name << " is empty." << std::endl;
+    exit(1);
+  }
+
+  for (auto& height : map.begin()->second)
+  {
+    heights_.push_back(double(height.first));
+  }
+  for (auto& width : map)
+  {
+    widths_.push_back(double(width.first));
+  }
+
+  values_.resize(heights_.size() * widths_.size());
+  std::size_t col = 0;
+  for (auto& width : map)
+  {
+    if (width.second.size() != heights_.size())
+    {
+      std::cerr << "ERROR: PAT table " << name << " is not a full grid (width "
+                << width.first << " has " << width.second.size() << " heights, expected "
+                << heights_.size() << ")." << std::endl;
+      exit(1);
+    }
+    std::size_t row = 0;
+    for (auto& height : width.second)
+    {
+      if (double(height.first) != heights_.at(row))
+      {
+        std::cerr << "ERROR: PAT table " << name << " is not a full grid (width "
+                  << width.first << " is missing height " << heights_.at(row) << ")." << std::endl;
+        exit(1);
+      }
+      values_[row * widths_.size() + col] = height.second;
+      row++;
+    }
+    col++;
+  }
+}
+
+// Finds the grid cell [axis[lo], axis[hi]] to interpolate in at x, and x's
+// position t within it (outside [0, 1] when extrapolating past an edge).
+static void Locate(const std::vector<double>& axis, double x, std::size_t& lo, std::size_t& hi, double& t)
+{
+  if (axis.size() == 1)
+  {
+    lo = hi = 0;
+    t = 0;
+    return;
+  }
+
+  std::size_t upper = std::upper_bound(axis.begin(), axis.end(), x) - axis.begin();
+  hi = std::min(std::max(upper, std::size_t(1)), axis.size() - 1);
+  lo = hi - 1;
+  t = (x - axis[lo]) / (axis[hi] - axis[lo]);
+}
+
+double Table2D::Lookup(double height, double width) const
+{
+  std::size_t r0, r1, c0, c1;
+  double tr, tc;
+  Locate(heights_, height, r0, r1, tr);
+  Locate(widths_, width, c0, c1, tc);
+
+  auto num_widths = widths_.size();
+  double v0 = (1 - tc) * values_[r0 * num_widths + c0] + tc * values_[r0 * num_widths + c1];
+  double v1 = (1 - tc) * values_[r1 * num_widths + c0] + tc * values_[r1 * num_widths + c1];
+  double value = (1 - tr) * v0 + tr * v1;
+
+  // Extrapolation must not produce negative energy or area.
+  return std::max(value, 0.0);
+}
+
+//
+// Table sets.
+//
+
+std::shared_ptr<Tables> Tables::Load(const std::string& dir)
+{
+  auto tables = std::make_shared<Tables>();
+  if (dir.empty())
+    return tables;
+
+  bool found = false;
+  for (unsigned i = 0; i < unsigned(TableID::Num); i++)
+  {
+    auto& name = TableName(TableID(i));
+    std::string prefix = dir + "/" + name;
+    if (!std::ifstream(prefix + ".csv").good())
+      continue;
+    tables->tables_[i] = std::make_shared<const Table2D>(name, ReadCSV(name, prefix));
+    found = true;
+  }
+
+  if (!found)
+  {
+    std::cerr << "WARNING: no PAT tables found in " << dir
+              << ", using the built-in models." << std::endl;
+  }
+  return tables;
+}
+
+std::shared_ptr<const Tables> Tables::Default()
+{
+  static const std::shared_ptr<const Tables> tables = []
+    {
+      std::string dir;
+      const char* dir_env = std::getenv("TIMELOOP_PAT_TABLES");
+      if (dir_env)
+      {
+        dir = dir_env;
+      }
+#ifdef PAT_TABLES_DIR
+      else
+      {
+        dir = PAT_TABLES_DIR;
+      }
+#endif
+      return Load(dir);
+    }();
+  return tables;
+}
+
+void Tables::Set(TableID id, const Map2D& map)
+{
+  tables_.at(unsigned(id)) = std::make_shared<const Table2D>(TableName(id), map);
+}
+
+//
+// Memoized lookup.
+//
+
+struct Query
+{
+  std::uint64_t serial;
+  double height;
+  double width;
+
+  bool operator == (const Query& other) const
+  {
+    return serial == other.serial && height == other.height && width == other.width;
+  }
+};
+
+struct QueryHash
+{
+  std::size_t operator () (const Query& query) const
+  {
+    std::uint64_t h, w;
+    std::memcpy(&h, &query.height, sizeof(h));
+    std::memcpy(&w, &query.width, sizeof(w));
+    std::size_t seed = std::hash<std::uint64_t>()(query.serial);
+    seed ^= std::hash<std::uint64_t>()(h) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= std::hash<std::uint64_t>()(w) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    return seed;
+  }
+};
+
+// Bound on the memo size. Queries come from spec-derived arguments, so
+// a run only ever sees a handful of distinct ones.
+static const std::size_t kMaxMemoEntries = 4096;
+
+bool Tables::Lookup(TableID id, double height, double width, double& value) const
+{
+  auto table = tables_[unsigned(id)].get();
+  if (!table)
+    return false;
+
+  // Installed tables are immutable and serial numbers are never reused, so
+  // entries cannot go stale.
+  thread_local std::unordered_map<Query, double, QueryHash> memo;
+  if (memo.size() >= kMaxMemoEntries)
+  {
+    memo.clear();
+  }
+
+  Query query = { table->Serial(), height, width };
+  auto it = memo.find(query);
+  if (it == memo.end())
+  {
+    it = memo.emplace(query, table->Lookup(height, width)).first;
+  }
+  value = it->second;
+  return true;
+}
+
+//
+// Technology models.
+//
+
+double SRAMArea(const Tables* tables, std::uint64_t height, std::uint64_t width,
+                std::uint64_t num_banks, std::uint64_t num_ports)
+{
+  double area;
+  if (tables && tables->Lookup(TableID::SRAMArea, height, width, area))
+    return area;
+  return pat::SRAMArea(height, width, num_banks, num_ports);
+}
+
+double SRAMEnergy(const Tables* tables, std::uint64_t height, std::uint64_t width,
+                  std::uint64_t num_banks, std::uint64_t num_ports)
+{
+  double energy;
+  if (tables && tables->Lookup(TableID::SRAMEnergy, height, width, energy))
+    return energy;
+  return pat::SRAMEnergy(height, width, num_banks, num_ports);
+}
+
+double DRAMEnergy(const Tables* tables, std::uint64_t width)
+{
+  double energy;
+  if (tables && tables->Lookup(TableID::DRAMEnergy, 0, width, energy))
+    return energy;
+  return pat::DRAMEnergy(width);
+}
+
+double WireEnergy(const Tables* tables, std::uint64_t bits, double length_mm)
+{
+  double energy_per_mm;
+  if (tables && tables->Lookup(TableID::WireEnergy, 0, bits, energy_per_mm))
+    return energy_per_mm * length_mm;
+  return pat::WireEnergy(bits, length_mm);
+}
+
+double MultiplierEnergy(const Tables* tables, std::uint64_t bits_A, std::uint64_t bits_B)
+{
+  double energy;
+  if (tables && tables->Lookup(TableID::MultiplierEnergy, bits_A, bits_B, energy))
+    return energy;
+  return pat::MultiplierEnergy(bits_A, bits_B);
+}
+
+double MultiplierArea(const Tables* tables, std::uint64_t bits_A, std::uint64_t bits_B)
+{
+  double area;
+  if (tables && tables->Lookup(TableID::MultiplierArea, bits_A, bits_B, area))
+    return area;
+  return pat::MultiplierArea(bits_A, bits_B);
+}
+
+double AdderEnergy(const Tables* tables, std::uint64_t bits_A, std::uint64_t bits_B)
+{
+  double energy;
+  if (tables && tables->Lookup(TableID::AdderEnergy, bits_A, bits_B, energy))
+    return energy;
+  return pat::AdderEnergy(bits_A, bits_B);
+}
+
+double AdderArea(const Tables* tables, std::uint64_t bits_A, std::uint64_t bits_B)
+{
+  double area;
+  if (tables && tables->Lookup(TableID::AdderArea, bits_A, bits_B, area))
+    return area;
+  return pat::AdderArea(bits_A, bits_B);
+}
+
+} // namespace tech
+
+} // namespace model
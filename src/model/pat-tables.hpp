@@ -0,0 +1,134 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "util/map2d.hpp"
+
+// ------------------------------------------------------------------------
+// Table-driven technology models.
+//
+// Technology tables are 2D maps in the util/map2d layout: the header row
+// lists the widths (columns), each following row gives a height and its
+// values. Tables are held as dense sorted grids and queried with bilinear
+// interpolation (linear extrapolation past the edges). A table with a
+// single row or column is interpolated along the other axis only.
+//
+// Engine::ParseSpecs() loads one set of tables per architecture, from the
+// directory named by its pat-tables key, else by TIMELOOP_PAT_TABLES, else
+// the one chosen at build time (scons --pat-tables=<dir>). Each table is
+// read from <dir>/<name>.csv, whose first header cell must be <name>. The
+// topology specs hand the set to every level and network, whose specs keep
+// it for the lookups they make while specced or evaluated. The functions in
+// namespace tech use a table when one is loaded and the pat model otherwise.
+// ------------------------------------------------------------------------
+
+namespace model
+{
+
+namespace tech
+{
+
+enum class TableID
+{
+  SRAMEnergy,       // "sram-energy":       height = entries, width = bits
+  SRAMArea,         // "sram-area":         height = entries, width = bits
+  DRAMEnergy,       // "dram-energy":       single row,       width = bits
+  MultiplierEnergy, // "multiplier-energy": height = bits A,  width = bits B
+  MultiplierArea,   // "multiplier-area":   height = bits A,  width = bits B
+  AdderEnergy,      // "adder-energy":      height = bits A,  width = bits B
+  AdderArea,        // "adder-area":        height = bits A,  width = bits B
+  WireEnergy,       // "wire-energy":       single row,       width = bits (per mm)
+  Num
+};
+
+const std::string& TableName(TableID id);
+
+class Table2D
+{
+ private:
+  std::uint64_t serial_; // Unique per table, keys the lookup memo.
+  std::vector<double> heights_;
+  std::vector<double> widths_;
+  std::vector<double> values_; // heights_.size() x widths_.size(), row-major.
+
+ public:
+  Table2D(const std::string& name, const Map2D& map);
+
+  std::uint64_t Serial() const { return serial_; }
+  double Lookup(double height, double width) const;
+};
+
+class Tables
+{
+ private:
+  std::array<std::shared_ptr<const Table2D>, unsigned(TableID::Num)> tables_;
+
+ public:
+  // Tables found in a directory (none if it is empty).
+  static std::shared_ptr<Tables> Load(const std::string& dir);
+
+  // Tables from TIMELOOP_PAT_TABLES or the build-time default, loaded once
+  // and shared by every architecture without a pat-tables key.
+  static std::shared_ptr<const Tables> Default();
+
+  // Installs a table, replacing the one (if any) loaded from the directory.
+  // Use this for tables compiled in from a header generated by
+  // WriteCPPHeader(), before the set is handed to any specs.
+  void Set(TableID id, const Map2D& map);
+
+  // Interpolated value of a table, memoized per thread. Returns false (and
+  // leaves value alone) if no table is installed for the ID.
+  bool Lookup(TableID id, double height, double width, double& value) const;
+};
+
+// Technology models, with the same arguments as their pat:: counterparts.
+// A null table set selects the pat models.
+//
+// The SRAM tables describe a single array of height entries by width bits,
+// so num_banks and num_ports only reach the pat models (which ignore them
+// too). Banked or multi-ported arrays need their own table directory.
+double SRAMArea(const Tables* tables, std::uint64_t height, std::uint64_t width,
+                std::uint64_t num_banks, std::uint64_t num_ports);
+double SRAMEnergy(const Tables* tables, std::uint64_t height, std::uint64_t width,
+                  std::uint64_t num_banks, std::uint64_t num_ports);
+double DRAMEnergy(const Tables* tables, std::uint64_t width);
+double WireEnergy(const Tables* tables, std::uint64_t bits, double length_mm);
+double MultiplierEnergy(const Tables* tables, std::uint64_t bits_A, std::uint64_t bits_B);
+double MultiplierArea(const Tables* tables, std::uint64_t bits_A, std::uint64_t bits_B);
+double AdderEnergy(const Tables* tables, std::uint64_t bits_A, std::uint64_t bits_B);
+double AdderArea(const Tables* tables, std::uint64_t bits_A, std::uint64_t bits_B);
+
+} // namespace tech
+
+} // namespace model
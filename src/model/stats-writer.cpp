@@ -0,0 +1,273 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string>
+#include <vector>
+
+#include "model/stats-writer.hpp"
+#include "util/json-writer.hpp"
+
+namespace model
+{
+
+//--------------------------------------------//
+//                    JSON                    //
+//--------------------------------------------//
+
+void WriteStatsJSON(std::ostream& out, const Topology& topology)
+{
+  auto& stats = topology.stats_;
+  unsigned num_data_spaces = problem::GetShape()->NumDataSpaces;
+
+  JSONWriter json(out);
+  json.BeginObject();
+
+  json.KeyValue("schema_version", kStatsSchemaVersion);
+
+  json.Key("data_spaces");
+  json.BeginArray();
+  for (unsigned pvi = 0; pvi < num_data_spaces; pvi++)
+    json.Value(problem::GetShape()->DataSpaceIDToName.at(pvi));
+  json.EndArray();
+
+  json.KeyValue("energy", stats.energy);
+  json.KeyValue("area", stats.area);
+  json.KeyValue("cycles", stats.cycles);
+  json.KeyValue("utilization", stats.utilization);
+  json.KeyValue("maccs", stats.maccs);
+  json.KeyValue("last_level_accesses", stats.last_level_accesses);
+
+  json.Key("levels");
+  json.BeginArray();
+  for (unsigned level_id = 0; level_id < topology.NumLevels(); level_id++)
+  {
+    auto level = topology.GetLevel(level_id);
+    bool is_arithmetic = (level_id == 0);
+
+    json.BeginObject();
+    json.KeyValue("name", level->Name());
+    json.KeyValue("class", is_arithmetic ? "arithmetic" : "storage");
+    json.KeyValue("cycles", level->Cycles());
+    json.KeyValue("energy", level->Energy());
+    json.KeyValue("area", level->Area());
+
+    if (is_arithmetic)
+    {
+      json.KeyValue("maccs", topology.GetArithmeticLevel()->MACCs());
+      json.KeyValue("utilized_instances", level->UtilizedInstances());
+    }
+    else
+    {
+      json.Key("data_spaces");
+      json.BeginObject();
+      for (unsigned pvi = 0; pvi < num_data_spaces; pvi++)
+      {
+        auto pv = problem::Shape::DataSpaceID(pvi);
+        json.Key(problem::GetShape()->DataSpaceIDToName.at(pv));
+        json.BeginObject();
+        json.KeyValue("accesses", level->Accesses(pv));
+        json.KeyValue("energy", level->Energy(pv));
+        json.KeyValue("tile_size", level->UtilizedCapacity(pv));
+        json.KeyValue("utilized_instances", level->UtilizedInstances(pv));
+        json.EndObject();
+      }
+      json.EndObject();
+    }
+
+    json.EndObject();
+  }
+  json.EndArray();
+
+  json.Key("networks");
+  json.BeginArray();
+  for (auto& network_kv: topology.networks_)
+  {
+    auto network = network_kv.second;
+    // Unconnected networks are never evaluated and carry zero energy.
+    bool evaluated = network->IsEvaluated();
+
+    json.BeginObject();
+    json.KeyValue("name", network->Name());
+    json.KeyValue("energy", evaluated ? network->Energy() : 0.0);
+    json.Key("data_spaces");
+    json.BeginObject();
+    for (unsigned pvi = 0; pvi < num_data_spaces; pvi++)
+    {
+      auto pv = problem::Shape::DataSpaceID(pvi);
+      json.Key(problem::GetShape()->DataSpaceIDToName.at(pv));
+      json.BeginObject();
+      json.KeyValue("energy", evaluated ? network->Energy(pv) : 0.0);
+      json.EndObject();
+    }
+    json.EndObject();
+    json.EndObject();
+  }
+  json.EndArray();
+
+  json.EndObject();
+  out << std::endl;
+}
+
+//--------------------------------------------//
+//                   Binary                   //
+//--------------------------------------------//
+
+namespace
+{
+
+template <typename T>
+void Put(std::ostream& out, T value)
+{
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void PutString(std::ostream& out, const std::string& str)
+{
+  Put<std::uint32_t>(out, str.size());
+  out.write(str.data(), str.size());
+}
+
+}  // namespace
+
+void WriteStatsBinary(std::ostream& out, const Topology& topology)
+{
+  auto& stats = topology.stats_;
+  unsigned num_data_spaces = problem::GetShape()->NumDataSpaces;
+
+  out.write(kStatsBinaryMagic, sizeof(kStatsBinaryMagic));
+  Put<std::uint32_t>(out, kStatsSchemaVersion);
+
+  Put<std::uint32_t>(out, num_data_spaces);
+  for (unsigned pvi = 0; pvi < num_data_spaces; pvi++)
+    PutString(out, problem::GetShape()->DataSpaceIDToName.at(pvi));
+
+  Put<double>(out, stats.energy);
+  Put<double>(out, stats.area);
+  Put<std::uint64_t>(out, stats.cycles);
+  Put<double>(out, stats.utilization);
+  Put<std::uint64_t>(out, stats.maccs);
+  Put<std::uint64_t>(out, stats.last_level_accesses);
+
+  Put<std::uint32_t>(out, topology.NumLevels());
+  for (unsigned level_id = 0; level_id < topology.NumLevels(); level_id++)
+  {
+    auto level = topology.GetLevel(level_id);
+    bool is_arithmetic = (level_id == 0);
+
+    PutString(out, level->Name());
+    Put<std::uint8_t>(out, is_arithmetic ? 0 : 1);
+    Put<std::uint64_t>(out, level->Cycles());
+    Put<double>(out, level->Energy());
+    Put<double>(out, level->Area());
+
+    for (unsigned pvi = 0; pvi < num_data_spaces; pvi++)
+    {
+      auto pv = problem::Shape::DataSpaceID(pvi);
+      if (is_arithmetic)
+      {
+        // Arithmetic units do not track per-dataspace stats.
+        Put<std::uint64_t>(out, 0);
+        Put<double>(out, 0.0);
+        Put<std::uint64_t>(out, 0);
+        Put<std::uint64_t>(out, level->UtilizedInstances());
+      }
+      else
+      {
+        Put<std::uint64_t>(out, level->Accesses(pv));
+        Put<double>(out, level->Energy(pv));
+        Put<std::uint64_t>(out, level->UtilizedCapacity(pv));
+        Put<std::uint64_t>(out, level->UtilizedInstances(pv));
+      }
+    }
+  }
+
+  Put<std::uint32_t>(out, topology.networks_.size());
+  for (auto& network_kv: topology.networks_)
+  {
+    auto network = network_kv.second;
+    bool evaluated = network->IsEvaluated();
+
+    PutString(out, network->Name());
+    Put<double>(out, evaluated ? network->Energy() : 0.0);
+    for (unsigned pvi = 0; pvi < num_data_spaces; pvi++)
+    {
+      auto pv = problem::Shape::DataSpaceID(pvi);
+      Put<double>(out, evaluated ? network->Energy(pv) : 0.0);
+    }
+  }
+}
+
+//--------------------------------------------//
+//               Configuration                //
+//--------------------------------------------//
+
+StatsFormats ParseStatsFormats(config::CompoundConfigNode node, std::string key)
+{
+  StatsFormats formats;
+
+  std::vector<std::string> names;
+  std::string name;
+  if (node.lookupValue(key, name))
+  {
+    names = { name };
+  }
+  else if (node.exists(key))
+  {
+    node.lookupArrayValue(key, names);
+  }
+  else
+  {
+    return formats;
+  }
+
+  formats.xml = false;
+  for (auto& format: names)
+  {
+    if (format == "xml")
+    {
+      formats.xml = true;
+    }
+    else if (format == "json")
+    {
+      formats.json = true;
+    }
+    else if (format == "binary")
+    {
+      formats.binary = true;
+    }
+    else
+    {
+      std::cerr << "ERROR: unrecognized stats format: " << format
+                << " (expected xml, json or binary)" << std::endl;
+      exit(1);
+    }
+  }
+
+  return formats;
+}
+
+}  // namespace model
@@ -0,0 +1,81 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <cstdint>
+
+#include "model/topology.hpp"
+#include "compound-config/compound-config.hpp"
+
+namespace model
+{
+
+// Machine-readable alternatives to the text and boost XML stats dumps.
+// Both formats carry the same content: global stats, per-level cycles,
+// energy and area, per-level/per-dataspace accesses, energy, tile sizes
+// and utilized instances, and per-network energies. Readers should check
+// the schema version before interpreting the payload; it is bumped whenever
+// a field is added, removed or reordered.
+const std::uint32_t kStatsSchemaVersion = 1;
+
+// Magic bytes at the start of a binary stats file.
+const char kStatsBinaryMagic[4] = { 'T', 'L', 'S', 'T' };
+
+// JSON, one object per file.
+void WriteStatsJSON(std::ostream& out, const Topology& topology);
+
+// Compact binary layout, all values in host byte order:
+//   char[4]  magic "TLST"
+//   u32      schema version
+//   u32      D, number of data spaces, followed by D strings
+//   f64 energy, f64 area, u64 cycles, f64 utilization, u64 maccs,
+//   u64 last_level_accesses
+//   u32      L, number of levels (arithmetic first), each:
+//              string name, u8 kind (0 = arithmetic, 1 = storage),
+//              u64 cycles, f64 energy, f64 area,
+//              D x { u64 accesses, f64 energy, u64 tile_size,
+//                    u64 utilized_instances }
+//   u32      N, number of networks, each:
+//              string name, f64 energy, D x f64 energy
+// Strings are encoded as a u32 length followed by the raw bytes.
+void WriteStatsBinary(std::ostream& out, const Topology& topology);
+
+// Output formats selected by the user. The key may hold a single string or
+// an array of strings out of "xml", "json" and "binary". Defaults to XML
+// only, which is what the applications have always emitted.
+struct StatsFormats
+{
+  bool xml = true;
+  bool json = false;
+  bool binary = false;
+};
+
+StatsFormats ParseStatsFormats(config::CompoundConfigNode node, std::string key);
+
+}  // namespace model
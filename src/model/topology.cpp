@@ -119,11 +119,11 @@ void Topology::Specs::ParseAccelergyERT(config::CompoundConfigNode ert)
       bool isArithmeticUnit = false;
       bool isBuffer = false;
       std::shared_ptr<LevelSpecs> specToUpdate;
-      for (auto level : levels) {
-        if (level->level_name == componentName) {
-          specToUpdate = level;
-          if (level->Type() == "BufferLevel") isBuffer = true;
-          if (level->Type() == "ArithmeticUnits") isArithmeticUnit = true;
+      for (unsigned level_id = 0; level_id < NumLevels(); level_id++) {
+        if (levels.at(level_id)->level_name == componentName) {
+          specToUpdate = CloneLevel(level_id);
+          if (specToUpdate->Type() == "BufferLevel") isBuffer = true;
+          if (specToUpdate->Type() == "ArithmeticUnits") isArithmeticUnit = true;
         }
       }
       // Find the most expensive action as the unit cost
@@ -148,7 +148,7 @@ void Topology::Specs::ParseAccelergyERT(config::CompoundConfigNode ert)
       // Replace the energy per action
       if (isArithmeticUnit) {
         // std::cout << "  Replace " << componentName << " energy with energy " << opEnergy << std::endl;
-        auto arithmeticSpec = GetArithmeticLevel();
+        auto arithmeticSpec = std::static_pointer_cast<ArithmeticUnits::Specs>(specToUpdate);
         arithmeticSpec->energy_per_op = opEnergy;
       } else if (isBuffer) {
         auto bufferSpec = std::static_pointer_cast<BufferLevel::Specs>(specToUpdate);
@@ -231,21 +231,28 @@ unsigned Topology::Specs::NumNetworks() const
   return networks.size();
 }
 
-std::shared_ptr<LevelSpecs> Topology::Specs::GetLevel(unsigned level_id) const
+std::shared_ptr<const LevelSpecs> Topology::Specs::GetLevel(unsigned level_id) const
 {
   return levels.at(level_id);
 }
 
-std::shared_ptr<BufferLevel::Specs> Topology::Specs::GetStorageLevel(unsigned storage_level_id) const
+std::shared_ptr<const BufferLevel::Specs> Topology::Specs::GetStorageLevel(unsigned storage_level_id) const
 {
   auto level_id = storage_map.at(storage_level_id);
-  return std::static_pointer_cast<BufferLevel::Specs>(levels.at(level_id));
+  return std::static_pointer_cast<const BufferLevel::Specs>(levels.at(level_id));
 }
 
-std::shared_ptr<ArithmeticUnits::Specs> Topology::Specs::GetArithmeticLevel() const
+std::shared_ptr<const ArithmeticUnits::Specs> Topology::Specs::GetArithmeticLevel() const
 {
   auto level_id = arithmetic_map;
-  return std::static_pointer_cast<ArithmeticUnits::Specs>(levels.at(level_id));
+  return std::static_pointer_cast<const ArithmeticUnits::Specs>(levels.at(level_id));
+}
+
+std::shared_ptr<LevelSpecs> Topology::Specs::CloneLevel(unsigned level_id)
+{
+  auto& level = levels.at(level_id);
+  level = level->Clone();
+  return level;
 }
 
 std::shared_ptr<LegacyNetwork::Specs> Topology::Specs::GetInferredNetwork(unsigned network_id) const
@@ -422,14 +429,15 @@ void Topology::Spec(const Topology::Specs& specs)
     // What type of level is this?
     if (level_specs->Type() == "BufferLevel")
     {
-      BufferLevel::Specs& specs = *std::static_pointer_cast<BufferLevel::Specs>(level_specs);
+      // The level shares the (read-only) specs.
+      auto specs = std::static_pointer_cast<const BufferLevel::Specs>(level_specs);
       std::shared_ptr<BufferLevel> buffer_level = std::make_shared<BufferLevel>(specs);
       level = std::static_pointer_cast<Level>(buffer_level);
       levels_.push_back(level);
     }
     else if (level_specs->Type() == "ArithmeticUnits")
     {
-      ArithmeticUnits::Specs& specs = *std::static_pointer_cast<ArithmeticUnits::Specs>(level_specs);
+      const ArithmeticUnits::Specs& specs = *std::static_pointer_cast<const ArithmeticUnits::Specs>(level_specs);
       std::shared_ptr<ArithmeticUnits> arithmetic_level = std::make_shared<ArithmeticUnits>(specs);
       level = std::static_pointer_cast<Level>(arithmetic_level);
       levels_.push_back(level);
@@ -453,10 +461,38 @@ void Topology::Spec(const Topology::Specs& specs)
     networks_[network->Name()] = network;
   }
 
-  //
-  // Connect levels to networks.
-  // FIXME: network source and sink need to be *bound* per-dataspace at eval (mapping) time.
-  //
+  ConnectLevels();
+
+  // DeriveFanouts();
+
+  is_specced_ = true;
+
+  FloorPlan();
+  CompileEvalPlan();
+
+  // Compute area at spec-time (instead of at eval-time).
+  // FIXME: area is being stored as a stat here, while it is stored as a spec
+  // in individual modules. We need to be consistent.
+  double area = 0;
+  for (auto level : levels_)
+  {
+    assert(level->Area() >= 0);
+    area += level->Area();
+  }
+  stats_.area = area;
+}
+
+//
+// Connect levels to networks, creating the inferred networks that are not in
+// networks_ yet. A copied topology already has clones of all its networks
+// and only needs to be re-linked.
+// FIXME: network source and sink need to be *bound* per-dataspace at eval (mapping) time.
+//
+void Topology::ConnectLevels()
+{
+  const Specs& specs = specs_;
+  connection_map_.clear();
+
   for (unsigned i = 0; i < specs.NumLevels()-1; i++)
   {
     // Note! We are linking levels[i+1] as the outer level for networks[i].
@@ -505,16 +541,18 @@ void Topology::Spec(const Topology::Specs& specs)
 
       // Inferred network i connects outer-level (i+1) to inner-level (i).
       // Inferred network i connects outer-storage-level (i) to inner-storage-level (i-1).
-      auto inferred_network_id = i;
-      auto inferred_network_specs = *specs.GetInferredNetwork(inferred_network_id);
-      std::shared_ptr<LegacyNetwork> legacy_network = std::make_shared<LegacyNetwork>(inferred_network_specs);
-      std::shared_ptr<Network> network = std::static_pointer_cast<Network>(legacy_network);
-
       std::string network_name = outer->Name() + " <==> " + inner->Name();
-      network->SetName(network_name);
-
-      networks_[network_name] = network;
-      read_fill_network = network;
+      auto it = networks_.find(network_name);
+      if (it == networks_.end())
+      {
+        auto inferred_network_id = i;
+        auto inferred_network_specs = *specs.GetInferredNetwork(inferred_network_id);
+        std::shared_ptr<LegacyNetwork> legacy_network = std::make_shared<LegacyNetwork>(inferred_network_specs);
+        std::shared_ptr<Network> network = std::static_pointer_cast<Network>(legacy_network);
+        network->SetName(network_name);
+        it = networks_.emplace(network_name, network).first;
+      }
+      read_fill_network = it->second;
 
       if (!inner_is_arithmetic)
       {
@@ -619,23 +657,6 @@ void Topology::Spec(const Topology::Specs& specs)
     connection_map_[i] = Connection{read_fill_network, drain_update_network};
 
   } // for all levels.
-
-  // DeriveFanouts();
-
-  is_specced_ = true;
-
-  FloorPlan();
-
-  // Compute area at spec-time (instead of at eval-time).
-  // FIXME: area is being stored as a stat here, while it is stored as a spec
-  // in individual modules. We need to be consistent.
-  double area = 0;
-  for (auto level : levels_)
-  {
-    assert(level->Area() >= 0);
-    area += level->Area();
-  }
-  stats_.area = area;
 }
 
 // The hierarchical ParseSpecs functions are static and do not
@@ -645,28 +666,30 @@ void Topology::Spec(const Topology::Specs& specs)
 // This function implements the "classic" hierarchical topology
 // with arithmetic units at level 0 and storage units at level 1+.
 Topology::Specs Topology::ParseSpecs(config::CompoundConfigNode storage,
-                                     config::CompoundConfigNode arithmetic)
+                                     config::CompoundConfigNode arithmetic,
+                                     std::shared_ptr<const tech::Tables> tables)
 {
   Specs specs;
+  specs.SetTables(tables);
   
   assert(storage.isList());
 
   // Level 0: arithmetic.
   // Use multiplication factor == 0 to ensure .instances attribute is set
-  auto level_specs_p = std::make_shared<ArithmeticUnits::Specs>(ArithmeticUnits::ParseSpecs(arithmetic, 0));
+  auto level_specs_p = std::make_shared<ArithmeticUnits::Specs>(ArithmeticUnits::ParseSpecs(arithmetic, 0, tables));
   specs.AddLevel(0, std::static_pointer_cast<LevelSpecs>(level_specs_p));
 
   // Storage levels.
   int num_storage_levels = storage.getLength();
   for (int i = 0; i < num_storage_levels; i++)
   {
-    auto level_specs_p = std::make_shared<BufferLevel::Specs>(BufferLevel::ParseSpecs(storage[i], 0));
+    auto level_specs_p = std::make_shared<BufferLevel::Specs>(BufferLevel::ParseSpecs(storage[i], 0, tables));
     specs.AddLevel(i, std::static_pointer_cast<LevelSpecs>(level_specs_p));
 
     // For each storage level, parse and extract an inferred network spec from the storage config.
     // A network object corresponding to this spec will only be instantiated if a user-specified
     // network is missing between any two topology levels.
-    auto inferred_network_specs_p = std::make_shared<LegacyNetwork::Specs>(LegacyNetwork::ParseSpecs(storage[i], 0));
+    auto inferred_network_specs_p = std::make_shared<LegacyNetwork::Specs>(LegacyNetwork::ParseSpecs(storage[i], 0, tables));
     specs.AddInferredNetwork(inferred_network_specs_p);
   }
 
@@ -676,9 +699,11 @@ Topology::Specs Topology::ParseSpecs(config::CompoundConfigNode storage,
 // This function implements the "tree-like" hierarchical architecture description
 // used in Accelergy v0.2. The lowest level is level 0 and should have
 // arithmetic units, while other level are level 1+ with some buffer/storage units
-Topology::Specs Topology::ParseTreeSpecs(config::CompoundConfigNode designRoot)
+Topology::Specs Topology::ParseTreeSpecs(config::CompoundConfigNode designRoot,
+                                         std::shared_ptr<const tech::Tables> tables)
 {
   Specs specs;
+  specs.SetTables(tables);
   auto curNode = designRoot;
 
   std::vector<std::shared_ptr<LevelSpecs>> storages; // serialize all storages
@@ -722,24 +747,24 @@ Topology::Specs Topology::ParseTreeSpecs(config::CompoundConfigNode designRoot)
         if (isBufferClass(cClass))
         {
           // Create a buffer spec.
-          auto level_specs_p = std::make_shared<BufferLevel::Specs>(BufferLevel::ParseSpecs(curLocal[c], nElements));
+          auto level_specs_p = std::make_shared<BufferLevel::Specs>(BufferLevel::ParseSpecs(curLocal[c], nElements, tables));
           localStorages.push_back(level_specs_p);
 
           // Create an inferred network spec.
           // A network object corresponding to this spec will only be instantiated if a user-specified
           // network is missing between any two topology levels.
-          auto inferred_network_specs_p = std::make_shared<LegacyNetwork::Specs>(LegacyNetwork::ParseSpecs(curLocal[c], nElements));
+          auto inferred_network_specs_p = std::make_shared<LegacyNetwork::Specs>(LegacyNetwork::ParseSpecs(curLocal[c], nElements, tables));
           localInferredNetworks.push_back(inferred_network_specs_p);
         }
         else if (isComputeClass(cClass))
         {
           // Create arithmetic.
-          auto level_specs_p = std::make_shared<ArithmeticUnits::Specs>(ArithmeticUnits::ParseSpecs(curLocal[c], nElements));
+          auto level_specs_p = std::make_shared<ArithmeticUnits::Specs>(ArithmeticUnits::ParseSpecs(curLocal[c], nElements, tables));
           specs.AddLevel(0, std::static_pointer_cast<LevelSpecs>(level_specs_p));
         }
         else if (isNetworkClass(cClass))
         {
-          auto network_specs_p = NetworkFactory::ParseSpecs(curLocal[c], nElements);
+          auto network_specs_p = NetworkFactory::ParseSpecs(curLocal[c], nElements, tables);
           localNetworks.push_back(network_specs_p);
         }
         else
@@ -820,18 +845,21 @@ std::shared_ptr<ArithmeticUnits> Topology::GetArithmeticLevel() const
 // can use to fail early.
 // FIXME: integrate with Evaluate() and re-factor.
 // FIXME: what about instances and fanout checks?
-std::vector<EvalStatus> Topology::PreEvaluationCheck(const Mapping& mapping,
-                                                     analysis::NestAnalysis* analysis,
-                                                     bool break_on_failure)
+const std::vector<EvalStatus>& Topology::PreEvaluationCheck(const Mapping& mapping,
+                                                            analysis::NestAnalysis* analysis,
+                                                            tiling::TilePipelineBuffers& tile_buffers,
+                                                            bool break_on_failure)
 {
-  auto masks = tiling::TransposeMasks(mapping.datatype_bypass_nest);
+  auto& masks = tile_buffers.masks;
+  tiling::TransposeMasks(mapping.datatype_bypass_nest, masks);
   auto working_set_sizes = analysis->GetWorkingSetSizes_LTW();
 
-  std::vector<EvalStatus> eval_status(NumLevels(), { .success = true, .fail_reason = "" });
-  for (unsigned storage_level_id = 0; storage_level_id < NumStorageLevels(); storage_level_id++)
+  auto& eval_status = eval_status_;
+  eval_status.assign(NumLevels(), EvalStatus());
+  for (unsigned storage_level_id = 0; storage_level_id < plan_.storage_levels.size(); storage_level_id++)
   {
-    auto level_id = specs_.StorageMap(storage_level_id);
-    auto s = GetStorageLevel(storage_level_id)->PreEvaluationCheck(
+    auto level_id = plan_.storage_level_ids[storage_level_id];
+    auto s = plan_.storage_levels[storage_level_id]->PreEvaluationCheck(
       working_set_sizes.at(storage_level_id), masks.at(storage_level_id),
       break_on_failure);
     eval_status.at(level_id) = s;
@@ -842,10 +870,12 @@ std::vector<EvalStatus> Topology::PreEvaluationCheck(const Mapping& mapping,
   return eval_status;
 }
 
-std::vector<EvalStatus> Topology::Evaluate(Mapping& mapping,
-                                           analysis::NestAnalysis* analysis,
-                                           const problem::Workload& workload,
-                                           bool break_on_failure)
+const std::vector<EvalStatus>& Topology::Evaluate(Mapping& mapping,
+                                                  analysis::NestAnalysis* analysis,
+                                                  const problem::Workload& workload,
+                                                  tiling::TilePipelineBuffers& tile_buffers,
+                                                  bool break_on_failure,
+                                                  unsigned stats_mask)
 {
   assert(is_specced_);
 
@@ -861,62 +891,55 @@ std::vector<EvalStatus> Topology::Evaluate(Mapping& mapping,
   //   network->ConnectBuffer(storage_level);
   // }  
 
-  std::vector<EvalStatus> eval_status(NumLevels(), { .success = true, .fail_reason = "" });
+  auto& eval_status = eval_status_;
+  eval_status.assign(NumLevels(), EvalStatus());
   bool success_accum = true;
   
   // Compute working-set tile hierarchy for the nest.
-  problem::PerDataSpace<std::vector<tiling::TileInfo>> ws_tiles;
+  const problem::PerDataSpace<std::vector<tiling::TileInfo>>* ws_tiles;
   try
   {
-    ws_tiles = analysis->GetWorkingSets();
+    ws_tiles = &analysis->GetWorkingSets();
   }
-  catch (std::runtime_error& e)
+  catch (analysis::EvalAborted& e)
   {
-    std::fill(eval_status.begin(), eval_status.end(),
-              EvalStatus({ .success = false, .fail_reason = "" }));
+    EvalStatus aborted;
+    aborted.Fail(analysis->GetAbortReason() == analysis::AbortReason::BudgetExceeded ?
+                 EvalStatus::BudgetExceeded : EvalStatus::Cancelled);
+    std::fill(eval_status.begin(), eval_status.end(), aborted);
     return eval_status;
   }
 
   // Ugh... FIXME.
   auto compute_cycles = analysis->GetBodyInfo().accesses;
 
-  // Create a mask indicating which levels support distributed multicast.
-  tiling::CompoundMaskNest distribution_supported;
-  for (unsigned pv = 0; pv < unsigned(problem::GetShape()->NumDataSpaces); pv++)
-  {
-    distribution_supported[pv].reset();
-    for (unsigned storage_level = 0; storage_level < NumStorageLevels(); storage_level++)
-    {
-      if (GetStorageLevel(storage_level)->GetReadNetwork()->DistributedMulticastSupported())
-      {
-        distribution_supported[pv].set(storage_level);
-      }
-    }
-  }
-  
-  // Collapse tiles into a specified number of tiling levels. The solutions are
-  // received in a set of per-problem::Shape::DataSpaceID arrays.
-  auto collapsed_tiles = tiling::CollapseTiles(ws_tiles, specs_.NumStorageLevels(),
-                                               mapping.datatype_bypass_nest,
-                                               distribution_supported);
-
-  // Transpose the tiles into level->datatype structure.
-  auto tiles = tiling::TransposeTiles(collapsed_tiles);
-  assert(tiles.size() == NumStorageLevels());
+  // Collapse tiles into a specified number of tiling levels and post-process
+  // them. The solutions are received in level->datatype structure.
+  unsigned num_storage_levels = plan_.storage_levels.size();
+  tiling::CollapseTiles(*ws_tiles, num_storage_levels,
+                        mapping.datatype_bypass_nest,
+                        plan_.distribution_supported, tile_buffers);
+  auto& tiles = tile_buffers.tiles;
+  assert(tiles.size() == num_storage_levels);
 
   // Transpose the datatype bypass nest into level->datatype structure.
-  auto keep_masks = tiling::TransposeMasks(mapping.datatype_bypass_nest);
-  assert(keep_masks.size() >= NumStorageLevels());
+  auto& keep_masks = tile_buffers.masks;
+  tiling::TransposeMasks(mapping.datatype_bypass_nest, keep_masks);
+  assert(keep_masks.size() >= num_storage_levels);
 
-  for (unsigned storage_level_id = 0; storage_level_id < NumStorageLevels(); storage_level_id++)
+  for (unsigned storage_level_id = 0; storage_level_id < num_storage_levels; storage_level_id++)
   {
-    auto storage_level = GetStorageLevel(storage_level_id);
+    auto storage_level = plan_.storage_levels[storage_level_id];
     
     // Evaluate Loop Nest on hardware structures: calculate
     // primary statistics.
-    auto level_id = specs_.StorageMap(storage_level_id);
-    auto s = storage_level->Evaluate(tiles[storage_level_id], keep_masks[storage_level_id],
-                                     compute_cycles, break_on_failure);
+    auto level_id = plan_.storage_level_ids[storage_level_id];
+    auto s = storage_level->EvaluateAccesses(tiles[storage_level_id], keep_masks[storage_level_id],
+                                             compute_cycles, break_on_failure);
+    if ((stats_mask & StatsEnergy) && (!break_on_failure || s.success))
+    {
+      storage_level->ComputeEnergy();
+    }
     eval_status.at(level_id) = s;
     success_accum &= s.success;
 
@@ -925,29 +948,31 @@ std::vector<EvalStatus> Topology::Evaluate(Mapping& mapping,
 
   }
 
-  unsigned int numConnections = NumStorageLevels();
+  for (auto network : plan_.networks)
+  {
+    network->ResetEvaluation();
+  }
+
+  unsigned int numConnections = plan_.read_fill_networks.size();
   for (uint32_t connection_id = 0; connection_id < numConnections; connection_id++)
   {
-    auto connection = connection_map_[connection_id];
-    auto rf_net = connection.read_fill_network;
+    auto rf_net = plan_.read_fill_networks[connection_id];
     EvalStatus s;
     if (!rf_net->IsEvaluated())
     {
       s = rf_net->Evaluate(tiles[connection_id], break_on_failure);
-      eval_status.at(connection_id).success &= s.success;
-      eval_status.at(connection_id).fail_reason += s.fail_reason;
+      eval_status.at(connection_id).Merge(s);
       success_accum &= s.success;
     }
 
     if (break_on_failure && !s.success)
       break;
 
-    auto du_net = connection.drain_update_network;
+    auto du_net = plan_.drain_update_networks[connection_id];
     if (!du_net->IsEvaluated())
     {
       s = du_net->Evaluate(tiles[connection_id], break_on_failure);
-      eval_status.at(connection_id).success &= s.success;
-      eval_status.at(connection_id).fail_reason += s.fail_reason;
+      eval_status.at(connection_id).Merge(s);
       success_accum &= s.success;
     }
 
@@ -957,15 +982,15 @@ std::vector<EvalStatus> Topology::Evaluate(Mapping& mapping,
 
   if (!break_on_failure || success_accum)
   {
-    auto level_id = specs_.ArithmeticMap();
-    auto s = GetArithmeticLevel()->HackEvaluate(analysis, workload);
+    auto level_id = plan_.arithmetic_level_id;
+    auto s = plan_.arithmetic_level->HackEvaluate(analysis, workload);
     eval_status.at(level_id) = s;
     success_accum &= s.success;
   }
 
   if (!break_on_failure || success_accum)
   {
-    ComputeStats();
+    ComputeStats(stats_mask);
   }
 
   if (success_accum)
@@ -976,71 +1001,143 @@ std::vector<EvalStatus> Topology::Evaluate(Mapping& mapping,
   return eval_status;
 }
 
-void Topology::ComputeStats()
+void Topology::CompleteStats()
+{
+  assert(is_evaluated_);
+
+  if (!(computed_stats_ & StatsEnergy))
+  {
+    for (auto storage_level : plan_.storage_levels)
+    {
+      storage_level->ComputeEnergy();
+    }
+  }
+
+  if (computed_stats_ != StatsAll)
+  {
+    ComputeStats(StatsAll);
+  }
+}
+
+void Topology::ComputeStats(unsigned stats_mask)
 {
-  // Energy.
+  auto num_storage_levels = plan_.storage_levels.size();
+
+  // Energy and cycles, accumulated in level order.
+  bool with_energy = stats_mask & StatsEnergy;
   double energy = 0;
-  for (auto level : levels_)
+  std::uint64_t cycles = 0;
+  for (int storage_level_id : plan_.level_to_storage_level)
   {
-    assert(level->Energy() >= 0);
-    energy += level->Energy();
+    double e = 0;
+    std::uint64_t c;
+    if (storage_level_id < 0)
+    {
+      if (with_energy)
+        e = plan_.arithmetic_level->Energy();
+      c = plan_.arithmetic_level->Cycles();
+    }
+    else
+    {
+      if (with_energy)
+        e = plan_.storage_levels[storage_level_id]->Energy();
+      c = plan_.storage_levels[storage_level_id]->Cycles();
+    }
+    assert(e >= 0);
+    energy += e;
+    cycles = std::max(cycles, c);
   }
 
-  for (auto& network: networks_)
+  for (auto network: plan_.networks)
   {
     //poan: Users might add a network to the arch but never connect/use it
     //      Such network should always have 0 energy though.
-    if (!network.second->IsEvaluated()) continue;
-    auto e = network.second->Energy();
+    if (!with_energy || !network->IsEvaluated()) continue;
+    auto e = network->Energy();
     assert(e >= 0);
     energy += e;
   }
 
   stats_.energy = energy;
-
-  // Cycles.
-  std::uint64_t cycles = 0;
-  for (auto level : levels_)
-  {
-    cycles = std::max(cycles, level->Cycles());
-  }
   stats_.cycles = cycles;
 
   // Utilization.
   // FIXME.
-  stats_.utilization = GetArithmeticLevel()->IdealCycles() / stats_.cycles;
+  stats_.utilization = plan_.arithmetic_level->IdealCycles() / stats_.cycles;
 
-  // Tile sizes.
-  stats_.tile_sizes.clear();
-  for (unsigned storage_level_id = 0; storage_level_id < NumStorageLevels(); storage_level_id++)
+  // Tile sizes and utilized instances.
+  if (stats_mask & StatsPerLevel)
   {
-    problem::PerDataSpace<std::uint64_t> ts;
-    for (unsigned pvi = 0; pvi < problem::GetShape()->NumDataSpaces; pvi++)
+    stats_.tile_sizes.resize(num_storage_levels);
+    stats_.utilized_instances.resize(num_storage_levels);
+    for (unsigned storage_level_id = 0; storage_level_id < num_storage_levels; storage_level_id++)
     {
-      auto pv = problem::Shape::DataSpaceID(pvi);
-      ts[pv] = GetStorageLevel(storage_level_id)->UtilizedCapacity(pv);
+      auto storage_level = plan_.storage_levels[storage_level_id];
+      for (unsigned pvi = 0; pvi < problem::GetShape()->NumDataSpaces; pvi++)
+      {
+        auto pv = problem::Shape::DataSpaceID(pvi);
+        stats_.tile_sizes[storage_level_id][pv] = storage_level->UtilizedCapacity(pv);
+        stats_.utilized_instances[storage_level_id][pv] = storage_level->UtilizedInstances(pv);
+      }
     }
-    stats_.tile_sizes.push_back(ts);
   }
-
-  // Utilized instances.
-  stats_.utilized_instances.clear();
-  for (unsigned storage_level_id = 0; storage_level_id < NumStorageLevels(); storage_level_id++)
+  else
   {
-    problem::PerDataSpace<std::uint64_t> uc;
-    for (unsigned pvi = 0; pvi < problem::GetShape()->NumDataSpaces; pvi++)
-    {
-      auto pv = problem::Shape::DataSpaceID(pvi);
-      uc[pv] = GetStorageLevel(storage_level_id)->UtilizedInstances(pv);
-    }
-    stats_.utilized_instances.push_back(uc);
+    stats_.tile_sizes.clear();
+    stats_.utilized_instances.clear();
   }
 
+  computed_stats_ = stats_mask;
+
   // MACCs.
-  stats_.maccs = GetArithmeticLevel()->MACCs();
+  stats_.maccs = plan_.arithmetic_level->MACCs();
 
   // Last-level accesses.
-  stats_.last_level_accesses = GetStorageLevel(NumStorageLevels()-1)->Accesses();
+  stats_.last_level_accesses = plan_.storage_levels.back()->Accesses();
+}
+
+void Topology::CompileEvalPlan()
+{
+  plan_ = EvalPlan();
+
+  auto num_storage_levels = NumStorageLevels();
+  plan_.level_to_storage_level.assign(NumLevels(), -1);
+  for (unsigned storage_level_id = 0; storage_level_id < num_storage_levels; storage_level_id++)
+  {
+    auto level_id = specs_.StorageMap(storage_level_id);
+    plan_.storage_levels.push_back(GetStorageLevel(storage_level_id).get());
+    plan_.storage_level_ids.push_back(level_id);
+    plan_.level_to_storage_level.at(level_id) = storage_level_id;
+  }
+
+  plan_.arithmetic_level_id = specs_.ArithmeticMap();
+  plan_.arithmetic_level = GetArithmeticLevel().get();
+  assert(plan_.level_to_storage_level.at(plan_.arithmetic_level_id) == -1);
+
+  for (unsigned connection_id = 0; connection_id < num_storage_levels; connection_id++)
+  {
+    auto& connection = connection_map_.at(connection_id);
+    plan_.read_fill_networks.push_back(connection.read_fill_network.get());
+    plan_.drain_update_networks.push_back(connection.drain_update_network.get());
+  }
+
+  for (auto& network: networks_)
+  {
+    plan_.networks.push_back(network.second.get());
+  }
+
+  // Mask indicating which levels support distributed multicast.
+  for (unsigned pv = 0; pv < unsigned(problem::GetShape()->NumDataSpaces); pv++)
+  {
+    plan_.distribution_supported[pv].reset();
+    for (unsigned storage_level_id = 0; storage_level_id < num_storage_levels; storage_level_id++)
+    {
+      if (plan_.storage_levels[storage_level_id]->GetReadNetwork()->DistributedMulticastSupported())
+      {
+        plan_.distribution_supported[pv].set(storage_level_id);
+      }
+    }
+  }
 }
 
 //
@@ -82,17 +82,20 @@ class Topology : public Module
     std::vector<std::shared_ptr<NetworkSpecs>> networks;
     std::map<unsigned, unsigned> storage_map;
     unsigned arithmetic_map;
+    std::shared_ptr<const tech::Tables> tables;
 
    public:
     // Constructors and assignment operators.
     Specs() = default;
     ~Specs() = default;
 
-    // We need an explicit deep-copy constructor because of shared_ptrs.
+    // Level specs are read-only once parsed, so copies share them (levels
+    // constructed from them share them too). ParseAccelergyERT(), the only
+    // in-place update, goes through CloneLevel(). Networks are
+    // deep-copied because of shared_ptrs.
     Specs(const Specs& other)
     {
-      for (auto& level_p: other.levels)
-        levels.push_back(level_p->Clone());
+      levels = other.levels;
 
       for (auto& inferred_network_p: other.inferred_networks)
         inferred_networks.push_back(std::make_shared<LegacyNetwork::Specs>(*inferred_network_p));
@@ -102,6 +105,7 @@ class Topology : public Module
 
       storage_map = other.storage_map;
       arithmetic_map = other.arithmetic_map;
+      tables = other.tables;
     }
 
     // Copy-and-swap idiom.
@@ -113,6 +117,7 @@ class Topology : public Module
       swap(first.networks, second.networks);
       swap(first.storage_map, second.storage_map);
       swap(first.arithmetic_map, second.arithmetic_map);
+      swap(first.tables, second.tables);
     }
 
     Specs& operator = (Specs other)
@@ -137,11 +142,19 @@ class Topology : public Module
     unsigned StorageMap(unsigned i) const { return storage_map.at(i); }
     unsigned ArithmeticMap() const { return arithmetic_map; }
 
-    std::shared_ptr<LevelSpecs> GetLevel(unsigned level_id) const;
-    std::shared_ptr<BufferLevel::Specs> GetStorageLevel(unsigned storage_level_id) const;
-    std::shared_ptr<ArithmeticUnits::Specs> GetArithmeticLevel() const;
+    // Technology tables the level and network specs were parsed with.
+    void SetTables(std::shared_ptr<const tech::Tables> t) { tables = t; }
+    std::shared_ptr<const tech::Tables> GetTables() const { return tables; }
+
+    std::shared_ptr<const LevelSpecs> GetLevel(unsigned level_id) const;
+    std::shared_ptr<const BufferLevel::Specs> GetStorageLevel(unsigned storage_level_id) const;
+    std::shared_ptr<const ArithmeticUnits::Specs> GetArithmeticLevel() const;
     std::shared_ptr<LegacyNetwork::Specs> GetInferredNetwork(unsigned network_id) const;
     std::shared_ptr<NetworkSpecs> GetNetwork(unsigned network_id) const;
+
+    // Replaces a level's specs with a private clone and returns it for
+    // modification, leaving copies that shared the old specs untouched.
+    std::shared_ptr<LevelSpecs> CloneLevel(unsigned level_id);
   };
 
   //
@@ -158,6 +171,17 @@ class Topology : public Module
     std::uint64_t maccs;
     std::uint64_t last_level_accesses;
   };
+
+  // Optional parts of the stats, selected per Evaluate() call. Validity,
+  // cycles, utilization, MACCs and last-level accesses are always computed.
+  // Skipped energy reads as 0 and skipped per-level vectors are empty until
+  // CompleteStats() is called.
+  enum StatsMask : unsigned
+  {
+    StatsEnergy = 1 << 0,    // energy breakdown of every level
+    StatsPerLevel = 1 << 1,  // tile_sizes and utilized_instances
+    StatsAll = StatsEnergy | StatsPerLevel
+  };
     
  private:
   std::vector<std::shared_ptr<Level>> levels_;
@@ -181,10 +205,34 @@ class Topology : public Module
   };
   std::map<unsigned, Connection> connection_map_;
 
+  // Evaluation plan, compiled by Spec() from the maps above. Evaluate() and
+  // ComputeStats() walk these flat, typed arrays instead of looking up and
+  // casting shared_ptrs for every mapping. Buffer and arithmetic levels are
+  // final classes, so calls through these pointers are direct. Pointers are
+  // owned by levels_ and networks_.
+  struct EvalPlan
+  {
+    std::vector<BufferLevel*> storage_levels;         // by storage level id
+    std::vector<unsigned> storage_level_ids;          // storage level id -> level id
+    std::vector<int> level_to_storage_level;          // level id -> storage level id (-1: arithmetic)
+    ArithmeticUnits* arithmetic_level = nullptr;
+    unsigned arithmetic_level_id = 0;
+    std::vector<Network*> read_fill_networks;         // by connection id
+    std::vector<Network*> drain_update_networks;      // by connection id
+    std::vector<Network*> networks;                   // in networks_ order
+    tiling::CompoundMaskNest distribution_supported;
+  };
+  EvalPlan plan_;
+
   std::map<unsigned, double> tile_area_;
 
   Specs specs_;
   Stats stats_;
+  unsigned computed_stats_ = StatsAll;
+
+  // Per-level status of the last PreEvaluationCheck() or Evaluate(),
+  // reused across calls.
+  std::vector<EvalStatus> eval_status_;
   
   // Serialization
   friend class boost::serialization::access;
@@ -202,8 +250,10 @@ class Topology : public Module
   std::shared_ptr<Level> GetLevel(unsigned level_id) const;
   std::shared_ptr<BufferLevel> GetStorageLevel(unsigned storage_level_id) const;
   std::shared_ptr<ArithmeticUnits> GetArithmeticLevel() const;
+  void ConnectLevels();
   void FloorPlan();
-  void ComputeStats();
+  void CompileEvalPlan();
+  void ComputeStats(unsigned stats_mask);
 
  public:
 
@@ -211,7 +261,10 @@ class Topology : public Module
   Topology() = default;
   ~Topology() = default;
 
-  // We need an explicit deep-copy constructor because of shared_ptrs.
+  // We need an explicit deep-copy constructor because of shared_ptrs. The
+  // cloned levels still point to the other topology's networks, so they are
+  // re-linked to the cloned networks and the evaluation plan is recompiled
+  // over the clones.
   Topology(const Topology& other)
   {
     is_specced_ = other.is_specced_;
@@ -226,6 +279,15 @@ class Topology : public Module
     tile_area_ = other.tile_area_;
     specs_ = other.specs_;
     stats_ = other.stats_;
+    computed_stats_ = other.computed_stats_;
+
+    if (is_specced_)
+    {
+      for (unsigned i = 0; i < levels_.size(); i++)
+        level_map_[i] = levels_[i];
+      ConnectLevels();
+      CompileEvalPlan();
+    }
   }
 
   // Copy-and-swap idiom.
@@ -236,9 +298,13 @@ class Topology : public Module
     swap(first.is_evaluated_, second.is_evaluated_);
     swap(first.levels_, second.levels_);
     swap(first.networks_, second.networks_);
+    swap(first.level_map_, second.level_map_);
+    swap(first.connection_map_, second.connection_map_);
+    swap(first.plan_, second.plan_);
     swap(first.tile_area_, second.tile_area_);
     swap(first.specs_, second.specs_);
     swap(first.stats_, second.stats_);
+    swap(first.computed_stats_, second.computed_stats_);
   }
 
   Topology& operator = (Topology other)
@@ -250,16 +316,29 @@ class Topology : public Module
   // The hierarchical ParseSpecs functions are static and do not
   // affect the internal specs_ data structure, which is set by
   // the dynamic Spec() call later.
-  static Specs ParseSpecs(config::CompoundConfigNode setting, config::CompoundConfigNode arithmetic_specs);
-  static Specs ParseTreeSpecs(config::CompoundConfigNode designRoot);
+  static Specs ParseSpecs(config::CompoundConfigNode setting, config::CompoundConfigNode arithmetic_specs,
+                          std::shared_ptr<const tech::Tables> tables);
+  static Specs ParseTreeSpecs(config::CompoundConfigNode designRoot,
+                              std::shared_ptr<const tech::Tables> tables);
   
   void Spec(const Specs& specs);
   unsigned NumLevels() const;
   unsigned NumStorageLevels() const;
   unsigned NumNetworks() const;
 
-  std::vector<EvalStatus> PreEvaluationCheck(const Mapping& mapping, analysis::NestAnalysis* analysis, bool break_on_failure);
-  std::vector<EvalStatus> Evaluate(Mapping& mapping, analysis::NestAnalysis* analysis, const problem::Workload& workload, bool break_on_failure);
+  // The returned status is owned by the topology and is valid until the
+  // next call to either function.
+  const std::vector<EvalStatus>& PreEvaluationCheck(const Mapping& mapping, analysis::NestAnalysis* analysis,
+                                                    tiling::TilePipelineBuffers& tile_buffers,
+                                                    bool break_on_failure);
+  const std::vector<EvalStatus>& Evaluate(Mapping& mapping, analysis::NestAnalysis* analysis,
+                                          const problem::Workload& workload,
+                                          tiling::TilePipelineBuffers& tile_buffers, bool break_on_failure,
+                                          unsigned stats_mask = StatsAll);
+
+  // Fills in the parts of the stats skipped by the last successful
+  // Evaluate(), from the level state it left behind.
+  void CompleteStats();
 
   const Stats& GetStats() const { return stats_; }
 
@@ -275,6 +354,8 @@ class Topology : public Module
   std::uint64_t LastLevelAccesses() const { return stats_.last_level_accesses; }
 
   friend std::ostream& operator<<(std::ostream& out, const Topology& sh);
+  friend void WriteStatsJSON(std::ostream& out, const Topology& topology);
+  friend void WriteStatsBinary(std::ostream& out, const Topology& topology);
 };
 
 }  // namespace model
@@ -210,6 +210,10 @@ class LinearPrunedSearch : public SearchAlgorithm
       //   no need to look at other LP, S combinations.
       eval_fail_count_++;
     }
+    else if (SkipsDatatypeBypass(status))
+    {
+      skip_datatype_bypass = true;
+    }
 
     if (iterator_[unsigned(mapspace::Dimension::DatatypeBypass)] + 1 ==
         mapspace_->Size(mapspace::Dimension::DatatypeBypass))
@@ -151,6 +151,13 @@ class RandomSearch : public SearchAlgorithm
         Roll(mapspace::Dimension::LoopPermutation);
         Roll(mapspace::Dimension::Spatial);
         Roll(mapspace::Dimension::DatatypeBypass);
+
+        // Most IDs in an unpruned mapspace only differ from another ID in
+        // where their unit-factor loops sit. Move to the canonical ID so
+        // that the draw is never skipped as a duplicate, and so that
+        // revisits are filtered across all IDs with the same mapping.
+        mapping_id_ = mapspace_->Canonicalize(mapping_id_);
+
         if (filter_revisits_)
         {
           if (visited_.find(mapping_id_.Integer()) == visited_.end())
@@ -36,7 +36,10 @@ enum class Status
 {
   Success,
   MappingConstructionFailure,
-  EvalFailure
+  EvalFailure,
+  EvalBudgetExceeded,
+  Duplicate,        // non-canonical for every DB of this (IF, LP, S)
+  BypassDuplicate   // non-canonical under this ID's DB only
 };
 
 class SearchAlgorithm
@@ -46,6 +49,29 @@ class SearchAlgorithm
   virtual ~SearchAlgorithm() {}
   virtual bool Next(mapspace::ID& mapping_id) = 0;
   virtual void Report(Status status, double cost = 0) = 0;
+
+ protected:
+  // Statuses that condemn a whole (IF, LP, S) rather than one datatype
+  // bypass choice of it. Enumerating searches skip the remaining DBs of the
+  // reported (IF, LP, S) when this returns true.
+  static bool SkipsDatatypeBypass(Status status)
+  {
+    switch (status)
+    {
+      case Status::EvalBudgetExceeded:
+        // Nest analysis ran out of budget =>
+        //   The loop nest of (IF, LP, S) is too expensive to analyze, and
+        //   bypassing does not change the nest.
+        return true;
+      case Status::Duplicate:
+        // Non-canonical mapping ID =>
+        //   (IF, LP, S) constructs the same nest as another ID, for every
+        //   DB. A BypassDuplicate only rules out its own DB.
+        return true;
+      default:
+        return false;
+    }
+  }
 };
 
 } // namespace search
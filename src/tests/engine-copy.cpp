@@ -0,0 +1,113 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+// Evaluates one mapping on an engine and on copies of it (copy-constructed,
+// assigned, and outliving the original) and checks that all of them agree.
+// Copies must carry a working evaluation plan of their own.
+//
+// Usage: timeloop-test-engine-copy [config] (default: configs/model/sample.cfg)
+
+#include <iostream>
+
+#include "model/engine.hpp"
+#include "mapping/parser.hpp"
+#include "compound-config/compound-config.hpp"
+
+bool gTerminate = false;
+bool gTerminateEval = false;
+
+struct Result
+{
+  bool success;
+  double energy;
+  std::uint64_t cycles;
+};
+
+Result Evaluate(model::Engine& engine, Mapping mapping, problem::Workload workload)
+{
+  auto& status = engine.Evaluate(mapping, workload);
+  for (auto& s: status)
+  {
+    if (!s.success)
+    {
+      std::cout << "evaluation failed: " << s.FailReason() << std::endl;
+      return { false, 0, 0 };
+    }
+  }
+  if (!engine.IsEvaluated())
+    return { false, 0, 0 };
+  return { true, engine.GetTopology().Energy(), engine.GetTopology().Cycles() };
+}
+
+bool Check(const std::string& what, const Result& ref, const Result& result)
+{
+  bool pass = result.success && result.energy == ref.energy && result.cycles == ref.cycles;
+  std::cout << (pass ? "PASS: " : "FAIL: ") << what << ": energy " << result.energy
+            << " (expected " << ref.energy << "), cycles " << result.cycles
+            << " (expected " << ref.cycles << ")" << std::endl;
+  return pass;
+}
+
+int main(int argc, char* argv[])
+{
+  std::string config_file = argc > 1 ? argv[1] : std::string(BUILD_BASE_DIR) + "/configs/model/sample.cfg";
+  config::CompoundConfig config(config_file.c_str());
+  auto root = config.getRoot();
+
+  problem::Workload workload;
+  problem::ParseWorkload(root.lookup("problem"), workload);
+
+  auto arch_specs = model::Engine::ParseSpecs(root.lookup("arch"));
+  auto mapping = mapping::ParseAndConstruct(root.lookup("mapping"), arch_specs, workload);
+
+  auto original = new model::Engine();
+  original->Spec(arch_specs);
+  auto ref = Evaluate(*original, mapping, workload);
+  if (!ref.success)
+  {
+    std::cout << "FAIL: reference mapping does not evaluate" << std::endl;
+    return 1;
+  }
+
+  bool pass = true;
+
+  model::Engine copied(*original);
+  pass &= Check("copy-constructed engine", ref, Evaluate(copied, mapping, workload));
+
+  model::Engine assigned;
+  assigned.Spec(arch_specs);
+  assigned = *original;
+  pass &= Check("assigned engine", ref, Evaluate(assigned, mapping, workload));
+
+  // The copies must not share levels or networks with the original.
+  model::Engine survivor(*original);
+  delete original;
+  pass &= Check("copy outliving its original", ref, Evaluate(survivor, mapping, workload));
+
+  return pass ? 0 : 1;
+}
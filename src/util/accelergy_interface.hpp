@@ -1,6 +1,20 @@
 #include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
 #include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
 #include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "yaml-cpp/yaml.h"
+#include "compound-config/compound-config.hpp"
 
 namespace accelergy
 {
@@ -52,4 +66,292 @@ namespace accelergy
 #endif
     return;
   }
+
+  //
+  // ERT cache.
+  //
+  // Running Accelergy costs a process launch plus the tool's own start-up
+  // on every run. If TIMELOOP_ACCELERGY_CACHE names a directory, generated
+  // ERTs are stored there under a hash of the Accelergy-relevant parts of
+  // the input files, together with a pre-parsed binary copy of the energy
+  // tables, and later runs with the same architecture skip Accelergy
+  // entirely. Sections that only Timeloop consumes (problem, mapper,
+  // mapping, constraints, ...) are excluded from the hash, so sweeps over
+  // those settings all share one entry. Clear the directory after changing
+  // Accelergy or its component libraries.
+  //
+
+  const std::uint32_t kERTCacheVersion = 1;
+
+  std::string ertCacheDir() {
+    const char* dir = std::getenv("TIMELOOP_ACCELERGY_CACHE");
+    return (dir == nullptr) ? "" : dir;
+  }
+
+  void hashBytes(std::uint64_t& hash, const std::string& bytes) {
+    // 64-bit FNV-1a.
+    for (unsigned char c : bytes) {
+      hash ^= c;
+      hash *= 0x100000001b3ULL;
+    }
+    // Delimit consecutive fields.
+    hash ^= 0xff;
+    hash *= 0x100000001b3ULL;
+  }
+
+  std::string hashInputFiles(std::vector<std::string> input_files) {
+    static const std::vector<std::string> timeloop_only_keys = {
+      "problem", "mapper", "mapping", "mapspace", "mapspace_constraints",
+      "arch_constraints", "architecture_constraints", "model", "server"
+    };
+
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    hashBytes(hash, std::to_string(kERTCacheVersion));
+    for (auto input_file : input_files) {
+      std::ifstream in(input_file);
+      std::stringstream contents;
+      contents << in.rdbuf();
+
+      YAML::Node root;
+      try {
+        root = YAML::Load(contents.str());
+      } catch (YAML::Exception&) {
+        root = YAML::Node();
+      }
+
+      if (root.IsMap()) {
+        // Hash the emitted form of each relevant top-level section so that
+        // comments and formatting do not affect the key.
+        for (auto section : root) {
+          auto key = section.first.as<std::string>();
+          if (std::find(timeloop_only_keys.begin(), timeloop_only_keys.end(), key) != timeloop_only_keys.end())
+            continue;
+          YAML::Emitter emitter;
+          emitter << section.second;
+          hashBytes(hash, key);
+          hashBytes(hash, emitter.c_str());
+        }
+      } else {
+        hashBytes(hash, contents.str());
+      }
+    }
+
+    std::stringstream key;
+    key << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return key.str();
+  }
+
+  bool copyFile(std::string from, std::string to) {
+    std::ifstream in(from, std::ios::binary);
+    if (!in) return false;
+    // Write to a temporary and rename so that concurrent runs sharing a
+    // cache never observe a partial file.
+    std::string tmp = to + ".tmp." + std::to_string(getpid());
+    {
+      std::ofstream out(tmp, std::ios::binary);
+      out << in.rdbuf();
+      if (!out) return false;
+    }
+    return std::rename(tmp.c_str(), to.c_str()) == 0;
+  }
+
+  // Binary ERT layout (host byte order): magic "TLEB", u32 version, u32
+  // number of components, then per component its name and u32 number of
+  // actions; per action its name, u8 is-list, u32 number of entries; per
+  // entry u8 has-energy, f64 energy, u32 number of arguments and the
+  // argument key/value strings. Strings are a u32 length plus raw bytes.
+
+  template <typename T>
+  void putValue(std::ostream& out, T value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  bool getValue(std::istream& in, T& value) {
+    return bool(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+  }
+
+  void putString(std::ostream& out, const std::string& str) {
+    putValue<std::uint32_t>(out, str.size());
+    out.write(str.data(), str.size());
+  }
+
+  bool getString(std::istream& in, std::string& str) {
+    std::uint32_t size;
+    if (!getValue(in, size)) return false;
+    str.resize(size);
+    return bool(in.read(&str[0], size));
+  }
+
+  bool putERTEntry(std::ostream& out, const YAML::Node& entry) {
+    double energy = 0.0;
+    bool has_energy = entry["energy"].IsDefined() && entry["energy"].IsScalar();
+    if (has_energy) energy = entry["energy"].as<double>();
+    putValue<std::uint8_t>(out, has_energy);
+    putValue<double>(out, energy);
+
+    auto arguments = entry["arguments"];
+    if (!arguments.IsDefined() || arguments.IsNull()) {
+      putValue<std::uint32_t>(out, 0);
+      return true;
+    }
+    if (!arguments.IsMap()) return false;
+    putValue<std::uint32_t>(out, arguments.size());
+    for (auto argument : arguments) {
+      if (!argument.second.IsScalar()) return false;
+      putString(out, argument.first.as<std::string>());
+      putString(out, argument.second.as<std::string>());
+    }
+    return true;
+  }
+
+  // Serializes the ERT energy tables. Returns false (and the caller keeps
+  // only the YAML copy) if the ERT uses a structure this format cannot hold.
+  bool writeBinaryERT(config::CompoundConfigNode ert, std::string path) {
+    std::string version;
+    if (!ert.lookupValue("version", version) || !ert.exists("tables")) return false;
+    auto tables = ert.lookup("tables").getYNode();
+
+    // Normalize to the 0.2 layout: component -> action -> entry or list.
+    YAML::Node formatted;
+    if (version == "0.3") {
+      for (auto component : tables) {
+        for (auto action : component["actions"]) {
+          formatted[component["name"].as<std::string>()][action["name"].as<std::string>()].push_back(action);
+        }
+      }
+    } else {
+      formatted = tables;
+    }
+    if (!formatted.IsMap()) return false;
+
+    std::stringstream out;
+    out.write("TLEB", 4);
+    putValue<std::uint32_t>(out, kERTCacheVersion);
+    putValue<std::uint32_t>(out, formatted.size());
+    for (auto component : formatted) {
+      if (!component.second.IsMap()) return false;
+      putString(out, component.first.as<std::string>());
+      putValue<std::uint32_t>(out, component.second.size());
+      for (auto action : component.second) {
+        putString(out, action.first.as<std::string>());
+        bool is_list = action.second.IsSequence();
+        putValue<std::uint8_t>(out, is_list);
+        if (is_list) {
+          putValue<std::uint32_t>(out, action.second.size());
+          for (auto entry : action.second) {
+            if (!putERTEntry(out, entry)) return false;
+          }
+        } else {
+          putValue<std::uint32_t>(out, 1);
+          if (!putERTEntry(out, action.second)) return false;
+        }
+      }
+    }
+
+    std::string tmp = path + ".tmp." + std::to_string(getpid());
+    {
+      std::ofstream file(tmp, std::ios::binary);
+      file << out.rdbuf();
+      if (!file) return false;
+    }
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+  }
+
+  bool getERTEntry(std::istream& in, YAML::Node& entry) {
+    std::uint8_t has_energy;
+    double energy;
+    std::uint32_t num_arguments;
+    if (!getValue(in, has_energy) || !getValue(in, energy) || !getValue(in, num_arguments)) return false;
+    if (has_energy) entry["energy"] = energy;
+    for (std::uint32_t i = 0; i < num_arguments; i++) {
+      std::string key, value;
+      if (!getString(in, key) || !getString(in, value)) return false;
+      entry["arguments"][key] = value;
+    }
+    return true;
+  }
+
+  // Rebuilds an ERT node (in the 0.2 layout) from its binary form.
+  bool readBinaryERT(std::string path, config::CompoundConfigNode& ert) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[4];
+    std::uint32_t version, num_components;
+    if (!in.read(magic, 4) || std::strncmp(magic, "TLEB", 4) != 0) return false;
+    if (!getValue(in, version) || version != kERTCacheVersion) return false;
+    if (!getValue(in, num_components)) return false;
+
+    YAML::Node root;
+    root["version"] = 0.2;
+    auto tables = root["tables"];
+    for (std::uint32_t c = 0; c < num_components; c++) {
+      std::string component_name;
+      std::uint32_t num_actions;
+      if (!getString(in, component_name) || !getValue(in, num_actions)) return false;
+      auto component = tables[component_name];
+      for (std::uint32_t a = 0; a < num_actions; a++) {
+        std::string action_name;
+        std::uint8_t is_list;
+        std::uint32_t num_entries;
+        if (!getString(in, action_name) || !getValue(in, is_list) || !getValue(in, num_entries)) return false;
+        if (is_list) {
+          for (std::uint32_t e = 0; e < num_entries; e++) {
+            YAML::Node entry;
+            if (!getERTEntry(in, entry)) return false;
+            component[action_name].push_back(entry);
+          }
+        } else {
+          YAML::Node entry;
+          if (!getERTEntry(in, entry)) return false;
+          component[action_name] = entry;
+        }
+      }
+    }
+
+    ert = config::CompoundConfigNode(nullptr, root);
+    return true;
+  }
+
+  // Returns the ERT for the given inputs, running Accelergy only when the
+  // cache (if enabled) has no entry for them. The ERT YAML is always left at
+  // <out_dir>/<out_prefix>.ERT.yaml, as with a direct Accelergy run.
+  config::CompoundConfigNode generateERT(std::vector<std::string> input_files, std::string out_prefix, std::string out_dir) {
+    std::string ert_path = out_dir + "/" + out_prefix + ".ERT.yaml";
+
+    std::string cache_dir = ertCacheDir();
+    std::string entry_prefix;
+    if (!cache_dir.empty()) {
+      mkdir(cache_dir.c_str(), 0755);
+      entry_prefix = cache_dir + "/" + hashInputFiles(input_files);
+
+      config::CompoundConfigNode ert;
+      if (readBinaryERT(entry_prefix + ".ERT.bin", ert)) {
+        std::cout << "Found cached Accelergy ERT: " << entry_prefix << ".ERT.bin" << std::endl;
+        copyFile(entry_prefix + ".ERT.yaml", ert_path);
+        return ert;
+      }
+
+      std::ifstream cached_yaml(entry_prefix + ".ERT.yaml");
+      if (cached_yaml.good()) {
+        std::cout << "Found cached Accelergy ERT: " << entry_prefix << ".ERT.yaml" << std::endl;
+        copyFile(entry_prefix + ".ERT.yaml", ert_path);
+        auto ertConfig = new config::CompoundConfig(ert_path.c_str());
+        return ertConfig->getRoot().lookup("ERT");
+      }
+    }
+
+    invokeAccelergy(input_files, out_prefix, out_dir);
+    auto ertConfig = new config::CompoundConfig(ert_path.c_str());
+    auto ert = ertConfig->getRoot().lookup("ERT");
+
+    if (!entry_prefix.empty()) {
+      if (copyFile(ert_path, entry_prefix + ".ERT.yaml")) {
+        writeBinaryERT(ert, entry_prefix + ".ERT.bin");
+      } else {
+        std::cerr << "WARNING: could not write Accelergy ERT cache entry " << entry_prefix << std::endl;
+      }
+    }
+
+    return ert;
+  }
 } // namespace accelergy
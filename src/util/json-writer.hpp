@@ -0,0 +1,173 @@
+/* Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <type_traits>
+
+//--------------------------------------------//
+//                JSON Writer                 //
+//--------------------------------------------//
+
+// A minimal streaming JSON emitter. Values are written to the output
+// stream as soon as they are supplied; the only state kept is one flag
+// per open object/array to place separators.
+
+class JSONWriter
+{
+ private:
+  std::ostream& out_;
+  std::vector<bool> first_;
+  bool after_key_ = false;
+
+  void Separator()
+  {
+    if (after_key_)
+    {
+      after_key_ = false;
+      return;
+    }
+    if (!first_.empty())
+    {
+      if (!first_.back())
+        out_ << ",";
+      first_.back() = false;
+    }
+  }
+
+  void String(const std::string& str)
+  {
+    out_ << '"';
+    for (char c: str)
+    {
+      switch (c)
+      {
+        case '"': out_ << "\\\""; break;
+        case '\\': out_ << "\\\\"; break;
+        case '\n': out_ << "\\n"; break;
+        case '\t': out_ << "\\t"; break;
+        case '\r': out_ << "\\r"; break;
+        default:
+          if (static_cast<unsigned char>(c) < 0x20)
+            out_ << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c)
+                 << std::dec << std::setfill(' ');
+          else
+            out_ << c;
+      }
+    }
+    out_ << '"';
+  }
+
+ public:
+  JSONWriter(std::ostream& out) :
+      out_(out)
+  {
+    out_ << std::setprecision(std::numeric_limits<double>::max_digits10);
+  }
+
+  void BeginObject()
+  {
+    Separator();
+    out_ << "{";
+    first_.push_back(true);
+  }
+
+  void EndObject()
+  {
+    first_.pop_back();
+    out_ << "}";
+  }
+
+  void BeginArray()
+  {
+    Separator();
+    out_ << "[";
+    first_.push_back(true);
+  }
+
+  void EndArray()
+  {
+    first_.pop_back();
+    out_ << "]";
+  }
+
+  void Key(const std::string& key)
+  {
+    Separator();
+    String(key);
+    out_ << ":";
+    after_key_ = true;
+  }
+
+  void Value(const std::string& value)
+  {
+    Separator();
+    String(value);
+  }
+
+  void Value(const char* value)
+  {
+    Value(std::string(value));
+  }
+
+  void Value(bool value)
+  {
+    Separator();
+    out_ << (value ? "true" : "false");
+  }
+
+  template <typename T>
+  typename std::enable_if<std::is_integral<T>::value>::type Value(T value)
+  {
+    Separator();
+    out_ << value;
+  }
+
+  template <typename T>
+  typename std::enable_if<std::is_floating_point<T>::value>::type Value(T value)
+  {
+    Separator();
+    // JSON has no representation for non-finite numbers.
+    if (std::isfinite(value))
+      out_ << value;
+    else
+      out_ << "null";
+  }
+
+  template <typename T>
+  void KeyValue(const std::string& key, const T& value)
+  {
+    Key(key);
+    Value(value);
+  }
+};
@@ -27,6 +27,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <vector>
 #include <utility>
@@ -608,6 +609,26 @@ class Factoradic
       }
     }
   }
+
+  // Inverse of Permute(): the index at which Permute() turns base into
+  // permuted.
+  std::uint64_t Index(const T* base, const T* permuted, std::size_t length)
+  {
+    std::vector<T> remaining(base, base + length);
+    std::uint64_t scale = factorial_table_[length];
+    std::uint64_t index = 0;
+
+    for (std::size_t i = 0; i < length; i++)
+    {
+      scale /= (std::uint64_t)(length - i);
+      auto it = std::find(remaining.begin(), remaining.end(), permuted[i]);
+      assert(it != remaining.end());
+      index += std::uint64_t(it - remaining.begin()) * scale;
+      remaining.erase(it);
+    }
+
+    return index;
+  }
 };
 
 //------------------------------------
@@ -66,21 +66,21 @@ Point OperationSpace::Project(Shape::DataSpaceID d,
                               const Workload* wc,
                               const OperationPoint& problem_point)
 {
-  Point data_space_point(wc->GetShape()->DataSpaceOrder.at(d));
+  // The projection expressions and coefficients are compiled down to a dense
+  // matrix once per workload (see Workload::CompileProjections()).
+  auto& projection = wc->GetProjection(d);
+  Point data_space_point(projection.num_rows);
 
-  for (unsigned data_space_dim = 0; data_space_dim < wc->GetShape()->DataSpaceOrder.at(d); data_space_dim++)
+  const Coordinate* row = projection.coefficients.data();
+  for (unsigned data_space_dim = 0; data_space_dim < projection.num_rows; data_space_dim++)
   {
-    data_space_point[data_space_dim] = 0;
-    for (auto& term : wc->GetShape()->Projections.at(d).at(data_space_dim))
+    Coordinate sum = 0;
+    for (unsigned dim = 0; dim < projection.num_cols; dim++)
     {
-      Coordinate x = problem_point[term.second];
-      // FIXME: somehow "compile" the coefficients down for a given
-      // workload config so that we avoid the branch and lookup below.
-      if (term.first != wc->GetShape()->NumCoefficients)
-        data_space_point[data_space_dim] += (x * wc->GetCoefficient(term.first));
-      else
-        data_space_point[data_space_dim] += x;
+      sum += row[dim] * problem_point[dim];
     }
+    data_space_point[data_space_dim] = sum;
+    row += projection.num_cols;
   }
 
   return data_space_point;
@@ -132,6 +132,20 @@ OperationSpace OperationSpace::operator - (const OperationSpace& p)
   return retval;
 }
 
+// Shifts every data space by the projection of an operation-space offset.
+// Empty data spaces are left in their canonical (reset) form so that they
+// still compare equal to empty deltas produced by set difference.
+OperationSpace& OperationSpace::Translate(const OperationPoint& offset)
+{
+  for (unsigned i = 0; i < data_spaces_.size(); i++)
+  {
+    if (!data_spaces_.at(i).empty())
+      data_spaces_.at(i).Translate(Project(i, workload_, offset));
+  }
+
+  return (*this);
+}
+
 PerDataSpace<std::size_t> OperationSpace::GetSizes() const
 {
   PerDataSpace<std::size_t> retval;
@@ -28,6 +28,7 @@
 #include <string>
 #include <cstring>
 #include <fstream>
+#include <stdexcept>
 
 #include "problem-shape.hpp"
 #include "workload.hpp"
@@ -51,6 +52,33 @@ const Shape* GetShape()
 //                 Workload                 //
 // ======================================== //
 
+void Workload::CompileProjections()
+{
+  auto shape = GetShape();
+
+  projections_.clear();
+  projections_.resize(shape->NumDataSpaces);
+
+  for (unsigned d = 0; d < shape->NumDataSpaces; d++)
+  {
+    auto& matrix = projections_.at(d);
+    matrix.num_rows = shape->DataSpaceOrder.at(d);
+    matrix.num_cols = shape->NumDimensions;
+    matrix.coefficients.assign(matrix.num_rows * matrix.num_cols, 0);
+
+    for (unsigned row = 0; row < matrix.num_rows; row++)
+    {
+      for (auto& term : shape->Projections.at(d).at(row))
+      {
+        Coordinate coefficient = 1;
+        if (term.first != shape->NumCoefficients)
+          coefficient = GetCoefficient(term.first);
+        matrix.coefficients.at(row * matrix.num_cols + term.second) += coefficient;
+      }
+    }
+  }
+}
+
 std::string ShapeFileName(const std::string shape_name)
 {
   std::string shape_file_path;
@@ -164,13 +192,18 @@ void ParseWorkload(config::CompoundConfigNode config, Workload& workload)
   }
 }
   
+// Throws std::runtime_error on a missing bound or density, leaving the
+// workload unchanged.
 void ParseWorkloadInstance(config::CompoundConfigNode config, Workload& workload)
 {
   // Loop bounds for each problem dimension.
   Workload::Bounds bounds;
   for (unsigned i = 0; i < GetShape()->NumDimensions; i++)
-    assert(config.lookupValue(GetShape()->DimensionIDToName.at(i), bounds[i]));
-  workload.SetBounds(bounds);
+  {
+    if (!config.lookupValue(GetShape()->DimensionIDToName.at(i), bounds[i]))
+      throw std::runtime_error("parsing problem: missing bound for dimension " +
+                               GetShape()->DimensionIDToName.at(i));
+  }
 
   Workload::Coefficients coefficients;
   for (unsigned i = 0; i < GetShape()->NumCoefficients; i++)
@@ -178,7 +211,6 @@ void ParseWorkloadInstance(config::CompoundConfigNode config, Workload& workload
     coefficients[i] = GetShape()->DefaultCoefficients.at(i);
     config.lookupValue(GetShape()->CoefficientIDToName.at(i), coefficients[i]);
   }
-  workload.SetCoefficients(coefficients);
   
   Workload::Densities densities;
   double common_density;
@@ -191,13 +223,20 @@ void ParseWorkloadInstance(config::CompoundConfigNode config, Workload& workload
   {
     auto config_densities = config.lookup("densities");
     for (unsigned i = 0; i < GetShape()->NumDataSpaces; i++)
-      assert(config_densities.lookupValue(GetShape()->DataSpaceIDToName.at(i), densities[i]));
+    {
+      if (!config_densities.lookupValue(GetShape()->DataSpaceIDToName.at(i), densities[i]))
+        throw std::runtime_error("parsing problem: missing density for data space " +
+                                 GetShape()->DataSpaceIDToName.at(i));
+    }
   }
   else
   {
     for (unsigned i = 0; i < GetShape()->NumDataSpaces; i++)
       densities[i] = 1.0;
   }
+
+  workload.SetBounds(bounds);
+  workload.SetCoefficients(coefficients);
   workload.SetDensities(densities);
 }
 
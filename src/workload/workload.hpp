@@ -52,6 +52,21 @@ namespace problem
 
 const Shape* GetShape();
 
+// ======================================== //
+//             Projection matrix            //
+// ======================================== //
+// The projection from the operation space into a single data space, compiled
+// down from the shape's projection expressions and the workload's
+// coefficients into a dense row-major matrix: one row per data-space
+// dimension, one column per problem dimension.
+
+struct ProjectionMatrix
+{
+  unsigned num_rows = 0;
+  unsigned num_cols = 0;
+  std::vector<Coordinate> coefficients;
+};
+
 // ======================================== //
 //                 Workload                 //
 // ======================================== //
@@ -68,6 +83,11 @@ class Workload
   Coefficients coefficients_;
   Densities densities_;
 
+  // Derived from the shape and coefficients_.
+  std::vector<ProjectionMatrix> projections_;
+
+  void CompileProjections();
+
  public:
   Workload() {}
 
@@ -87,6 +107,11 @@ class Workload
     return coefficients_.at(p);
   }
   
+  const ProjectionMatrix& GetProjection(Shape::DataSpaceID d) const
+  {
+    return projections_.at(d);
+  }
+
   double GetDensity(Shape::DataSpaceID pv) const
   {
     return densities_.at(pv);
@@ -100,6 +125,7 @@ class Workload
   void SetCoefficients(const Coefficients& coefficients)
   {
     coefficients_ = coefficients;
+    CompileProjections();
   }
   
   void SetDensities(const Densities& densities)
@@ -118,6 +144,10 @@ class Workload
       ar& BOOST_SERIALIZATION_NVP(bounds_);
       ar& BOOST_SERIALIZATION_NVP(coefficients_);
       ar& BOOST_SERIALIZATION_NVP(densities_);
+      if (typename Archive::is_loading())
+      {
+        CompileProjections();
+      }
     }
   }
 };